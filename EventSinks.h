@@ -0,0 +1,363 @@
+#ifndef EVENTSINKS_H
+#define EVENTSINKS_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include "Events.h"
+#include "Logger.h"
+#include "ConsoleOutput.h"
+using namespace std;
+
+// Event sinks for BasicMatchingEngine. A sink is any type with the handlers
+// below; the engine calls them directly, so there is no virtual dispatch and
+// an empty handler compiles away entirely.
+
+inline void writeOrderBookFiles(const OrderBook& orderBook) {
+    ofstream buyFile("buy book.txt"), sellFile("sell book.txt");
+
+    buyFile << "=== BUY BOOK ===\n";
+    buyFile << "BUY ORDER BOOK (Last updated: " << currentTimestamp() << ")\n";
+    for (const auto& pair : orderBook.getBuyBook()) {
+        const auto& queue = pair.second;
+        for (const auto& order : queue) {
+            buyFile << "ID#" << order.id << " | Qty: " << order.quantity
+                    << " | Price: " << order.price << "\n";
+        }
+    }
+
+    sellFile << "=== SELL BOOK ===\n";
+    sellFile << "SELL ORDER BOOK (Last updated: " << currentTimestamp() << ")\n";
+    for (const auto& pair : orderBook.getSellBook()) {
+        const auto& queue = pair.second;
+        for (const auto& order : queue) {
+            sellFile << "ID#" << order.id << " | Qty: " << order.quantity
+                    << " | Price: " << order.price << "\n";
+        }
+    }
+}
+
+// The text/CSV logs, console output and book files read by the web interface.
+class FileEventSink {
+public:
+    void onOrderAccepted(const OrderAcceptedEvent& event) {
+        string entry = orderEntry(event.order);
+        appendToFile("order history log.txt", "ORDER PLACED: " + entry);
+        appendToFile("all_info.txt", "ORDER PLACED: " + entry);
+        appendToCSV("ORDER PLACED", entry);
+    }
+
+    // Rejected PLACEs have no ID yet; rejected MODIFYs keep the order's ID.
+    void onOrderRejected(const OrderRejectedEvent& event) {
+        const Order& order = event.order;
+        string entry = event.isAmend
+            ? orderEntry(order) + " | Action: MODIFY | Reason: " + event.reason
+            : orderDetails(order) + " | Action: PLACE | Reason: " + event.reason;
+        appendToFile("all_info.txt", "ORDER REJECTED: " + entry);
+        appendToCSV("ORDER REJECTED", entry);
+        if (event.isAmend) {
+            writeToConsole("Order ID " + to_string(order.id) + " modify rejected: " + event.reason + ".");
+        } else {
+            writeToConsole("Order rejected: " + event.reason + ".");
+        }
+    }
+
+    void onTrade(const TradeEvent& event) {
+        string entry = "BUY#" + to_string(event.buyOrder.id) +
+            " <--> SELL#" + to_string(event.sellOrder.id) +
+            " | Price: " + to_string(event.price) +
+            " | Qty: " + to_string(event.quantity);
+
+        appendToFile("trades.txt","TRADE: " + entry);
+        appendToFile("all_info.txt", "TRADE: " + entry);
+        appendToCSV("TRADE", entry);
+    }
+
+    void onCancel(const CancelEvent& event) {
+        const Order& order = event.order;
+        string entry = cancelEntry(order, event.reason, event.type);
+
+        appendToFile("cancelledorder.txt", "ORDER CANCELED: " + entry);
+        appendToFile("all_info.txt", "ORDER CANCELED: " + entry);
+        appendToCSV("ORDER CANCELED", entry);
+
+        const string& reason = event.reason;
+        string tag = order.side + "#" + to_string(order.id) + "] ";
+        if (reason == "fok_unfilled") {
+            writeToConsole("[FOK " + tag + "Not fully fillable - " + to_string(order.quantity) + " units canceled.");
+        } else if (reason.find("market_unfilled") != string::npos) {
+            writeToConsole("[MARKET " + tag + "Partial or no match - " + to_string(order.quantity) + " units canceled.");
+        } else if (reason.find("ioc_unfilled") != string::npos) {
+            writeToConsole("[IOC " + tag + "Partial or no match - " + to_string(order.quantity) + " units canceled.");
+        } else if (reason == "expired") {
+            writeToConsole("Order ID " + to_string(order.id) + " expired.");
+        } else if (reason.compare(0, 5, "risk_") == 0) {
+            writeToConsole("Stop order ID " + to_string(order.id) + " canceled on trigger: " + reason.substr(5) + ".");
+        } else if (reason == "user_cancel") {
+            writeToConsole("Order ID " + to_string(order.id) + " canceled.");
+        }
+    }
+
+    // One open per log file for the whole batch instead of one per order.
+    void onMassCancel(const MassCancelEvent& event) {
+        string timestamp = currentTimestamp();
+        ofstream cancelFile("cancelledorder.txt", ios::app);
+        ofstream infoFile("all_info.txt", ios::app);
+        ofstream csvFile("all_info.csv", ios::app);
+        for (const auto& order : event.orders) {
+            string entry = cancelEntry(order, event.reason, event.type);
+            writeLogLine(cancelFile, timestamp, "ORDER CANCELED: " + entry);
+            writeLogLine(infoFile, timestamp, "ORDER CANCELED: " + entry);
+            writeCSVLine(csvFile, timestamp, "ORDER CANCELED", entry);
+        }
+        writeToConsole("Mass cancel: " + to_string(event.orders.size()) + " orders canceled.");
+    }
+
+    void onAmend(const AmendEvent& event) {
+        string entry = "ID#" + to_string(event.order.id) +
+            (event.field == "PRICE" ? " | New Price: " : " | New QTY: ") + to_string(event.value);
+        appendToFile("all_info.txt", "ORDER MODIFIED: " + entry);
+        appendToCSV("ORDER MODIFIED", entry);
+        writeToConsole("Order ID " + to_string(event.order.id) + " modified.");
+    }
+
+    void onStopTriggered(const StopTriggeredEvent& event) {
+        const Order& order = event.order;
+        string entry = "ID#" + to_string(order.id) +
+                    " | " + order.side + " " + order.type +
+                    " | Trigger: " + to_string(order.stopPrice) +
+                    " | Traded: " + to_string(event.tradePrice);
+        appendToFile("all_info.txt", "STOP TRIGGERED: " + entry);
+        appendToCSV("STOP TRIGGERED", entry);
+    }
+
+    void onBookUpdate(const BookUpdateEvent& event) {
+        writeOrderBookFiles(event.book);
+    }
+
+    void onMessage(const string& message) {
+        writeToConsole(message);
+    }
+
+private:
+    static string cancelEntry(const Order& order, const string& reason, const string& type) {
+        return "ID#" + to_string(order.id) +
+               " | " + order.side + " " + order.type +
+               " | Qty: " + to_string(order.quantity) +
+               " | Reason: " + reason + " | Type: " + type;
+    }
+
+    static string orderEntry(const Order& order) {
+        return "ID#" + to_string(order.id) + " | " + orderDetails(order);
+    }
+
+    static string orderDetails(const Order& order) {
+        string entry = order.side + " " + order.type +
+                       " | Price: " + to_string(order.price) +
+                       " | Qty: " + to_string(order.quantity) +
+                       " | Account: " + order.account +
+                       " | TIF: " + order.tif;
+        if (order.stopPrice > 0) {
+            entry += " | Trigger: " + to_string(order.stopPrice);
+        }
+        return entry;
+    }
+};
+
+// Discards everything; for benchmarks and deployments that want no I/O on
+// the matching path.
+class NullEventSink {
+public:
+    void onOrderAccepted(const OrderAcceptedEvent&) {}
+    void onOrderRejected(const OrderRejectedEvent&) {}
+    void onTrade(const TradeEvent&) {}
+    void onCancel(const CancelEvent&) {}
+    void onMassCancel(const MassCancelEvent&) {}
+    void onAmend(const AmendEvent&) {}
+    void onStopTriggered(const StopTriggeredEvent&) {}
+    void onBookUpdate(const BookUpdateEvent&) {}
+    void onMessage(const string&) {}
+};
+
+// Appends fixed-size binary records to a journal file. Every record carries
+// the order's full state (type, TIF, expiry, account, stop price) and the
+// reason for rejects and cancels, so the books can be rebuilt by replaying
+// ACCEPTED, AMEND, TRADE, CANCEL and STOP_TRIGGERED records in order. Book
+// updates and console messages are not journaled. Text fields are NUL-padded
+// and hold up to 31 characters: every engine reason fits, and main limits
+// account ids to that length (longer ids from other callers are truncated).
+class BinaryJournalSink {
+public:
+    enum RecordKind : uint8_t {
+        ACCEPTED = 1,
+        REJECTED = 2,
+        TRADE = 3,
+        CANCEL = 4,
+        AMEND = 5,
+        STOP_TRIGGERED = 6,
+        AMEND_REJECTED = 7
+    };
+
+    struct JournalRecord {
+        int64_t timestampNs;
+        int64_t expireAt;     // epoch seconds, DAY/GTD only
+        double price;         // order price; trade price for trades, traded high/low for triggers
+        double stopPrice;     // trigger price, STOP/STOP_LIMIT only
+        int32_t orderId;      // buy id for trades
+        int32_t otherId;      // sell id for trades, 0 otherwise
+        int32_t quantity;     // open quantity; traded quantity for trades
+        uint8_t kind;
+        uint8_t side;         // 'B' or 'S'
+        char orderType[12];   // LIMIT, MARKET, STOP or STOP_LIMIT
+        char tif[4];          // GTC, IOC, FOK, DAY or GTD
+        char account[32];
+        char reason[32];      // reject/cancel reason, amended field for AMEND
+        uint8_t padding[2];
+    };
+
+    explicit BinaryJournalSink(const string& path = "journal.bin")
+    : journal(path, ios::binary | ios::app) {}
+
+    void onOrderAccepted(const OrderAcceptedEvent& event) {
+        write(ACCEPTED, event.order, event.order.price, event.order.quantity);
+    }
+
+    void onOrderRejected(const OrderRejectedEvent& event) {
+        write(event.isAmend ? AMEND_REJECTED : REJECTED, event.order, event.order.price,
+              event.order.quantity, 0, event.reason);
+    }
+
+    void onTrade(const TradeEvent& event) {
+        write(TRADE, event.buyOrder, event.price, event.quantity, event.sellOrder.id);
+    }
+
+    void onCancel(const CancelEvent& event) {
+        write(CANCEL, event.order, event.order.price, event.order.quantity, 0, event.reason);
+    }
+
+    void onMassCancel(const MassCancelEvent& event) {
+        for (const auto& order : event.orders) {
+            write(CANCEL, order, order.price, order.quantity, 0, event.reason);
+        }
+    }
+
+    void onAmend(const AmendEvent& event) {
+        write(AMEND, event.order, event.order.price, event.order.quantity, 0, event.field);
+    }
+
+    void onStopTriggered(const StopTriggeredEvent& event) {
+        write(STOP_TRIGGERED, event.order, event.tradePrice, event.order.quantity);
+    }
+
+    void onBookUpdate(const BookUpdateEvent&) {}
+    void onMessage(const string&) {}
+
+private:
+    ofstream journal;
+
+    template <size_t N>
+    static void copyField(char (&field)[N], const string& value) {
+        value.copy(field, N - 1);
+    }
+
+    void write(RecordKind kind, const Order& order, double price, int quantity, int otherId = 0,
+               const string& reason = "") {
+        JournalRecord record{};
+        record.timestampNs = chrono::duration_cast<chrono::nanoseconds>(
+            chrono::system_clock::now().time_since_epoch()).count();
+        record.expireAt = order.expireAt;
+        record.price = price;
+        record.stopPrice = order.stopPrice;
+        record.orderId = order.id;
+        record.otherId = otherId;
+        record.quantity = quantity;
+        record.kind = kind;
+        record.side = (order.side == "BUY") ? 'B' : 'S';
+        copyField(record.orderType, order.type);
+        copyField(record.tif, order.tif);
+        copyField(record.account, order.account);
+        copyField(record.reason, reason);
+        journal.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+};
+
+// Keeps copies of every event in memory, for tests and in-process inspection.
+class CaptureEventSink {
+public:
+    struct Trade {
+        int buyId;
+        int sellId;
+        double price;
+        int quantity;
+    };
+
+    struct CanceledOrder {
+        Order order;
+        string reason;
+        string type;
+    };
+
+    struct Rejection {
+        Order order;
+        string reason;
+        bool isAmend;
+    };
+
+    struct Amendment {
+        Order order;
+        string field;
+        double value;
+    };
+
+    vector<Order> accepted;
+    vector<Rejection> rejected;
+    vector<Trade> trades;
+    vector<CanceledOrder> canceledOrders;
+    vector<Amendment> amendments;
+    vector<Order> triggeredStops;
+    vector<string> messages;
+    int bookUpdates = 0;
+
+    void onOrderAccepted(const OrderAcceptedEvent& event) {
+        accepted.push_back(event.order);
+    }
+
+    void onOrderRejected(const OrderRejectedEvent& event) {
+        rejected.push_back({event.order, event.reason, event.isAmend});
+    }
+
+    void onTrade(const TradeEvent& event) {
+        trades.push_back({event.buyOrder.id, event.sellOrder.id, event.price, event.quantity});
+    }
+
+    void onCancel(const CancelEvent& event) {
+        canceledOrders.push_back({event.order, event.reason, event.type});
+    }
+
+    void onMassCancel(const MassCancelEvent& event) {
+        for (const auto& order : event.orders) {
+            canceledOrders.push_back({order, event.reason, event.type});
+        }
+    }
+
+    void onAmend(const AmendEvent& event) {
+        amendments.push_back({event.order, event.field, event.value});
+    }
+
+    void onStopTriggered(const StopTriggeredEvent& event) {
+        triggeredStops.push_back(event.order);
+    }
+
+    void onBookUpdate(const BookUpdateEvent&) {
+        bookUpdates++;
+    }
+
+    void onMessage(const string& message) {
+        messages.push_back(message);
+    }
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <string>
+#include <vector>
+#include "Order.h"
+#include "OrderBook.h"
+using namespace std;
+
+// Typed outputs of the matching engine. Events only reference engine state
+// and are valid for the duration of the sink call.
+
+struct OrderAcceptedEvent {
+    const Order& order;
+};
+
+struct OrderRejectedEvent {
+    const Order& order;
+    const string& reason;
+    bool isAmend;
+};
+
+struct TradeEvent {
+    const Order& buyOrder;
+    const Order& sellOrder;
+    double price;
+    int quantity;
+};
+
+struct CancelEvent {
+    const Order& order;
+    const string& reason;
+    const string& type;   // "manual" or "automatic"
+};
+
+struct MassCancelEvent {
+    const vector<Order>& orders;
+    const string& reason;
+    const string& type;
+};
+
+struct AmendEvent {
+    const Order& order;
+    const string& field;  // "PRICE" or "QTY"
+    double value;
+};
+
+struct StopTriggeredEvent {
+    const Order& order;
+    double tradePrice;   // the traded high (buy stops) or low (sell stops)
+};
+
+struct BookUpdateEvent {
+    const OrderBook& book;
+};
+
+#endif
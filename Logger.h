@@ -14,9 +14,21 @@ inline string currentTimestamp() {
     return ss.str();
 }
 
+// Line formats shared by the single-entry appenders and by batch writers
+// that keep one stream open for many entries.
+inline void writeLogLine(ostream& out, const string& timestamp, const string& content) {
+    out << "[" << timestamp << "] " << content << "\n";
+}
+
+inline void writeCSVLine(ostream& out, const string& timestamp, const string& logType, const string& details) {
+    out << "\"" << timestamp << "\","
+        << "\"" << logType << "\","
+        << "\"" << details << "\"\n";
+}
+
 inline void appendToFile(const string& filename, const string& content) {
     ofstream file(filename, ios::app);  
-    file << "[" << currentTimestamp() << "] " << content << "\n";
+    writeLogLine(file, currentTimestamp(), content);
 }
 
 inline void clearLogs() {
@@ -30,7 +42,10 @@ inline void clearLogs() {
         "all_info.csv",
         "buy book.csv",
         "sell book.csv",
+        "stop book.csv",
         "last_id.txt",
+        "positions.csv",
+        "last_price.txt",
         "console_output.txt"  
     };
 
@@ -46,7 +61,11 @@ inline void clearLogs() {
         if (file == "all_info.csv") {
             ofs << "Timestamp,Type,Details\n";
         } else if (file == "buy book.csv" || file == "sell book.csv") {
-            ofs << "ID,Side,Type,Price,Quantity,Timestamp\n";
+            ofs << "ID,Side,Type,Price,Quantity,Timestamp,Account,TIF,ExpireAt\n";
+        } else if (file == "stop book.csv") {
+            ofs << "ID,Side,Type,Price,Quantity,Timestamp,Account,TIF,ExpireAt,StopPrice\n";
+        } else if (file == "positions.csv") {
+            ofs << "Account,Position\n";
         } else if (file == "last_id.txt") {
             ofs << "0";  
         } else{
@@ -57,7 +76,5 @@ inline void clearLogs() {
 
 inline void appendToCSV(const string& logType, const string& details) {
     ofstream file("all_info.csv", ios::app); 
-    file << "\"" << currentTimestamp() << "\","
-         << "\"" << logType << "\","
-         << "\"" << details << "\"\n";
+    writeCSVLine(file, currentTimestamp(), logType, details);
 }
@@ -4,95 +4,156 @@
 #include "OrderBook.h"
 #include "Order.h"
 #include "Utils.h"
-#include "Logger.h"
-#include "ConsoleOutput.h"
+#include "RiskManager.h"
+#include "TimerWheel.h"
+#include "StopBook.h"
+#include "Events.h"
+#include "EventSinks.h"
 #include <vector>
+#include <algorithm>
+#include <stdexcept>
 using namespace std;
 
-class MatchingEngine {
+// The engine is parameterized on its event sink (see EventSinks.h). All
+// logging, console output and book publishing goes through the sink, so with
+// NullEventSink the matching path does no I/O at all. Persisted state (books,
+// positions, last ID) is only read or written by the explicit load/save calls.
+template <typename EventSink>
+class BasicMatchingEngine {
 private:
     OrderBook orderBook;
-    int orderIdCounter = loadLastAssignedId(); 
-
-    Order* findOrderInFiles(int orderId) {
-        ifstream buyFile("buy book.txt");
-        string line;
-        while (getline(buyFile, line)) {
-            if (line.find("ID#" + to_string(orderId)) != string::npos) {
-                size_t qtyPos = line.find("Qty: ") + 5;
-                size_t pricePos = line.find("Price: ") + 7;
-                int qty = stoi(line.substr(qtyPos, line.find(" |", qtyPos) - qtyPos));
-                double price = stod(line.substr(pricePos));
-                return new Order(orderId, "BUY", "LIMIT", price, qty, getCurrentTimestamp());
-            }
-        }
+    StopBook stopBook;
+    RiskManager risk;
+    TimerWheel expiryWheel{currentEpochSeconds()};
+    EventSink sink;
+    int orderIdCounter = 1;
+
+    // Highest and lowest trade price since stops were last checked (0 = no
+    // trades). An aggressor can sweep through a trigger and back within one
+    // match, so stops are fired from the range rather than the last price.
+    double tradeHigh = 0;
+    double tradeLow = 0;
+
+    // Upper bound on trigger rounds per command, so a stop cascade cannot
+    // run away. The unprocessed trade range only lives in memory: within one
+    // engine it carries over to the next processStops(), and a fresh engine
+    // re-seeds it from the last trade price in releaseCrossedStops(). Stops
+    // crossed only by an earlier price of the cut-off sweep stay pending until
+    // the price crosses them again.
+    static const int MAX_STOP_CASCADE = 64;
+
+    Order* findLiveOrder(int orderId) {
+        Order* order = orderBook.findOrder(orderId, "BUY");
+        return order ? order : orderBook.findOrder(orderId, "SELL");
+    }
 
-        ifstream sellFile("sell book.txt");
-        while (getline(sellFile, line)) {
-            if (line.find("ID#" + to_string(orderId)) != string::npos) {
-                size_t qtyPos = line.find("Qty: ") + 5;
-                size_t pricePos = line.find("Price: ") + 7;
-                int qty = stoi(line.substr(qtyPos, line.find(" |", qtyPos) - qtyPos));
-                double price = stod(line.substr(pricePos));
-                return new Order(orderId, "SELL", "LIMIT", price, qty, getCurrentTimestamp());
-            }
-        }
+    void publishBook() {
+        sink.onBookUpdate({orderBook});
+    }
 
-        return nullptr;
+    void recordTradePrice(double price) {
+        if (tradeHigh == 0 || price > tradeHigh) tradeHigh = price;
+        if (tradeLow == 0 || price < tradeLow) tradeLow = price;
     }
 
 public:
-    struct Trade {
-        int buyId;
-        int sellId;
-        double price;
-        int quantity;
-        string timestamp;
-    };
-
-    struct CanceledOrder {
-        Order order;
-        string reason; 
-        string type;    
-    };
-
-    vector<Trade> tradeLog;
-    vector<CanceledOrder> canceledOrders;
+    EventSink& getEventSink() {
+        return sink;
+    }
 
     void logCanceledOrder(const Order& order, const string& reason, const string& type) {
-        string entry = "ID#" + to_string(order.id) +
-                    " | " + order.side + " " + order.type +
-                    " | Qty: " + to_string(order.quantity) +
-                    " | Reason: " + reason + " | Type: " + type;
-
-        appendToFile("cancelledorder.txt", "ORDER CANCELED: " + entry);
-        appendToFile("all_info.txt", "ORDER CANCELED: " + entry);
-        appendToCSV("ORDER CANCELED", entry);
-        
-        canceledOrders.push_back({order, reason, type});
-        writeOrderBookToFile();
+        sink.onCancel({order, reason, type});
     }
 
 
-    void placeOrder(string side, string type, double price, int quantity) {
-        string timestamp = getCurrentTimestamp();
-        Order newOrder(orderIdCounter++, side, type, price, quantity, timestamp);
-        
-        string logEntry = "ID#" + to_string(newOrder.id) +
-                       " | " + side + " " + type +
-                       " | Price: " + to_string(price) +
-                       " | Qty: " + to_string(quantity);
-
-        appendToFile("order history log.txt", "ORDER PLACED: " + logEntry);
-        appendToFile("all_info.txt", "ORDER PLACED: " + logEntry);
-        appendToCSV("ORDER PLACED", logEntry);
-        
-        if (side == "BUY") {
-            matchBuyOrder(newOrder);
-        } else if (side == "SELL") {
-            matchSellOrder(newOrder);
+    void placeOrder(string side, string type, double price, int quantity, string account = "DEFAULT",
+                    string tif = "GTC", long long expireAt = 0, double stopPrice = 0) {
+        // Rejected orders never get an ID, so accepted orders stay contiguous.
+        Order newOrder(0, side, type, price, quantity, currentEpochNanos(), account);
+        newOrder.tif = tif;
+        newOrder.expireAt = expireAt;
+        newOrder.stopPrice = stopPrice;
+
+        string rejectReason = risk.checkOrder(newOrder, orderBook);
+        if (!rejectReason.empty()) {
+            sink.onOrderRejected({newOrder, rejectReason, false});
+            return;
+        }
+        newOrder.id = orderIdCounter++;
+
+        sink.onOrderAccepted({newOrder});
+
+        if (type == "STOP" || type == "STOP_LIMIT") {
+            // Pending stops count toward the account's open quantity, so a
+            // batch of stops cannot add up to more than the limits allow.
+            stopBook.addStop(newOrder);
+            risk.onRest(newOrder);
+            // A stop placed through the last price fires right away.
+            if (risk.getLastTradePrice() > 0) {
+                recordTradePrice(risk.getLastTradePrice());
+            }
+        } else {
+            executeOrder(newOrder);
+        }
+        processStops();
+        publishBook();
+    }
+
+    void executeOrder(Order& order) {
+        if (order.tif == "FOK" && orderBook.availableQuantity(order, order.quantity) < order.quantity) {
+            logCanceledOrder(order, "fok_unfilled", "automatic");
+            return;
+        }
+
+        if (order.side == "BUY") {
+            matchBuyOrder(order);
+        } else if (order.side == "SELL") {
+            matchSellOrder(order);
+        }
+    }
+
+    // Releases stops triggered by the trades since the last check into
+    // matching: buy stops against the highest price traded, sell stops against
+    // the lowest. Each round only pops the triggered range of the stop book;
+    // trades made by released orders can trigger more stops in the next round. A triggered
+    // order is checked again as the MARKET/LIMIT order it becomes, since the
+    // book and the collar reference have moved since it was placed.
+    int processStops() {
+        int released = 0;
+        for (int round = 0; round < MAX_STOP_CASCADE && tradeHigh > 0; round++) {
+            double high = tradeHigh;
+            double low = tradeLow;
+            tradeHigh = tradeLow = 0;
+
+            vector<Order> triggered = stopBook.popTriggered(high, low);
+            released += (int)triggered.size();
+            for (auto& order : triggered) {
+                sink.onStopTriggered({order, order.side == "BUY" ? high : low});
+                order.type = (order.type == "STOP") ? "MARKET" : "LIMIT";
+
+                // The stop's own quantity is already counted as open.
+                string rejectReason = risk.checkOrder(order, orderBook, order.quantity);
+                risk.onRemove(order, order.quantity);
+                if (!rejectReason.empty()) {
+                    logCanceledOrder(order, "risk_" + rejectReason, "automatic");
+                    continue;
+                }
+                executeOrder(order);
+            }
+        }
+        return released;
+    }
+
+    // Fires pending stops that the last trade price has already crossed, e.g.
+    // ones left over when an earlier command hit MAX_STOP_CASCADE. Called once
+    // after the books and risk state are loaded.
+    void releaseCrossedStops() {
+        if (risk.getLastTradePrice() > 0) {
+            recordTradePrice(risk.getLastTradePrice());
+        }
+        if (processStops() > 0) {
+            publishBook();
         }
-        writeOrderBookToFile();
     }
 
     void matchBuyOrder(Order& buyOrder) {
@@ -112,20 +173,14 @@ public:
                 buyOrder.quantity -= tradedQty;
                 sellOrder.quantity -= tradedQty;
 
-                tradeLog.push_back({buyOrder.id, sellOrder.id, sellOrder.price, tradedQty, getCurrentTimestamp()});
-                string entry = "BUY#" + to_string(buyOrder.id) + 
-                    " <--> SELL#" + to_string(sellOrder.id) +
-                    " | Price: " + to_string(sellOrder.price) +
-                    " | Qty: " + to_string(tradedQty);
-
-                appendToFile("trades.txt","TRADE: " + entry);
-                appendToFile("all_info.txt", "TRADE: " + entry);
-                appendToCSV("TRADE", entry);
+                risk.onFill(buyOrder, sellOrder, sellOrder, tradedQty, sellOrder.price);
+                recordTradePrice(sellOrder.price);
+                orderBook.reduceDepth("SELL", sellOrder.price, tradedQty);
+                sink.onTrade({buyOrder, sellOrder, sellOrder.price, tradedQty});
                 
                 if (sellOrder.quantity == 0) {
                     sellQueue.pop_front();
                 }
-                writeOrderBookToFile();
             }
 
             if (sellQueue.empty()) {
@@ -135,17 +190,7 @@ public:
             }
         }
 
-        if (buyOrder.quantity > 0) {
-            if (buyOrder.type == "LIMIT") {
-                orderBook.addOrder(buyOrder);
-            } else {
-                writeToConsole("[MARKET BUY#" + to_string(buyOrder.id) + "] Partial or no match - "
-                        + to_string(buyOrder.quantity) + " units canceled.");
-                string reason = (buyOrder.quantity == originalQty) ? "market_unfilled" : "partial_market_unfilled";
-                logCanceledOrder(buyOrder, reason, "automatic");
-            }
-        }
-
+        handleRemainder(buyOrder, originalQty);
     }
 
     void matchSellOrder(Order& sellOrder) {
@@ -166,20 +211,14 @@ public:
                 sellOrder.quantity -= tradedQty;
                 buyOrder.quantity -= tradedQty;
 
-                tradeLog.push_back({buyOrder.id, sellOrder.id, buyOrder.price, tradedQty, getCurrentTimestamp()});
-                string entry = "BUY#" + to_string(buyOrder.id) + 
-                    " <--> SELL#" + to_string(sellOrder.id) +
-                    " | Price: " + to_string(buyOrder.price) +
-                    " | Qty: " + to_string(tradedQty);
-
-                appendToFile("trades.txt","TRADE: " + entry);
-                appendToFile("all_info.txt", "TRADE: " + entry);
-                appendToCSV("TRADE", entry);
+                risk.onFill(buyOrder, sellOrder, buyOrder, tradedQty, buyOrder.price);
+                recordTradePrice(buyOrder.price);
+                orderBook.reduceDepth("BUY", buyOrder.price, tradedQty);
+                sink.onTrade({buyOrder, sellOrder, buyOrder.price, tradedQty});
                 
                 if (buyOrder.quantity == 0) {
                     buyQueue.pop_front();
                 }
-                writeOrderBookToFile();
             }
 
             if (buyQueue.empty()) {
@@ -189,236 +228,219 @@ public:
             }
         }
 
-        if (sellOrder.quantity > 0) {
-            if (sellOrder.type == "LIMIT") {
-                orderBook.addOrder(sellOrder);
-            } else {
-                writeToConsole("[MARKET SELL#" + to_string(sellOrder.id) + "] Partial or no match - "
-                        + to_string(sellOrder.quantity) + " units canceled.");
-                string reason = (sellOrder.quantity == originalQty) ? "market_unfilled" : "partial_market_unfilled";
-                logCanceledOrder(sellOrder, reason, "automatic");
+        handleRemainder(sellOrder, originalQty);
+    }
+
+    // Rests what is left of a LIMIT GTC/DAY/GTD order; MARKET, IOC and FOK
+    // remainders are canceled instead.
+    void handleRemainder(Order& order, int originalQty) {
+        if (order.quantity == 0) return;
+
+        if (order.type == "LIMIT" && order.tif != "IOC" && order.tif != "FOK") {
+            orderBook.addOrder(order);
+            risk.onRest(order);
+            if (order.expireAt > 0) {
+                expiryWheel.schedule(order.expireAt, order.id, order.side, order.price);
             }
+            return;
+        }
+
+        string tag = (order.type == "MARKET") ? "market" : (order.tif == "IOC" ? "ioc" : "fok");
+        string reason = (order.quantity == originalQty) ? tag + "_unfilled" : "partial_" + tag + "_unfilled";
+        logCanceledOrder(order, reason, "automatic");
+    }
+
+    // Cancels every DAY/GTD order whose expiry has passed. Timers for orders
+    // that already filled or were canceled simply find nothing to remove.
+    void expireOrders() {
+        vector<TimerEntry> expired = expiryWheel.advance(currentEpochSeconds());
+        bool removedAny = false;
+        for (const auto& entry : expired) {
+            Order removed(entry.orderId, entry.side, "LIMIT", entry.price, 0, 0);
+            if (!orderBook.removeOrder(entry.orderId, entry.side, entry.price, removed)) continue;
+
+            risk.onRemove(removed, removed.quantity);
+            logCanceledOrder(removed, "expired", "automatic");
+            removedAny = true;
+        }
+        if (removedAny) {
+            publishBook();
         }
     }
 
     void cancelOrder(int orderId) {
-        Order* order = findOrderInFiles(orderId);
-        if (!order) {
-            writeToConsole("Order ID " + to_string(orderId) + " not found.");
+        Order removed(orderId, "", "", 0, 0, 0);
+        if (stopBook.removeStop(orderId, removed)) {
+            risk.onRemove(removed, removed.quantity);
+            logCanceledOrder(removed, "user_cancel", "manual");
             return;
         }
 
-        bool orderFound = false;
-        if (order->side == "BUY") {
-            auto& buyBook = orderBook.getBuyBook();
-            for (auto& priceLevelPair : buyBook) {
-                auto& queue = priceLevelPair.second;
-                for (auto it = queue.begin(); it != queue.end(); ++it) {
-                    if (it->id == orderId) {
-                        logCanceledOrder(*order, "user_cancel", "manual");
-                        queue.erase(it);
-                        orderFound = true;
-                        break;
-                    }
-                }
-                if (orderFound) {
-                    if (queue.empty()) {
-                        buyBook.erase(priceLevelPair.first);
-                    }
-                    break;
-                }
-            }
-        } else {
-            auto& sellBook = orderBook.getSellBook();
-            for (auto& priceLevelPair : sellBook) {
-                auto& queue = priceLevelPair.second;
-                for (auto it = queue.begin(); it != queue.end(); ++it) {
-                    if (it->id == orderId) {
-                        logCanceledOrder(*order, "user_cancel", "manual");
-                        queue.erase(it);
-                        orderFound = true;
-                        break;
-                    }
-                }
-                if (orderFound) {
-                    if (queue.empty()) {
-                        sellBook.erase(priceLevelPair.first);
-                    }
-                    break;
-                }
-            }
+        Order* order = findLiveOrder(orderId);
+        if (!order) {
+            sink.onMessage("Order ID " + to_string(orderId) + " not found.");
+            return;
         }
 
-        if (orderFound) {
-            writeToConsole("Order ID " + to_string(orderId) + " canceled.");
-            delete order;
-            writeOrderBookToFile();
-        } else {
-            writeToConsole("Order ID " + to_string(orderId) + " not found in book.");
-            delete order;
+        orderBook.removeOrder(orderId, order->side, order->price, removed);
+        risk.onRemove(removed, removed.quantity);
+        logCanceledOrder(removed, "user_cancel", "manual");
+        publishBook();
+    }
+
+    // Cancels every resting and pending stop order on `side` ("BUY", "SELL" or
+    // "ALL") priced within [minPrice, maxPrice] (0 = unbounded; stops are
+    // matched on trigger price), optionally only for one account. Whole levels
+    // are removed at once, and the cancels go out as one batch followed by a
+    // single book update.
+    int massCancel(const string& side, double minPrice, double maxPrice, const string& account = "") {
+        vector<Order> removed;
+        if (side != "SELL") {
+            orderBook.removeOrders("BUY", minPrice, maxPrice, account, removed);
+        }
+        if (side != "BUY") {
+            orderBook.removeOrders("SELL", minPrice, maxPrice, account, removed);
         }
+        stopBook.removeStops(side, minPrice, maxPrice, account, removed);
+        for (const auto& order : removed) {
+            risk.onRemove(order, order.quantity);
+        }
+
+        const string reason = "mass_cancel";
+        const string type = "manual";
+        sink.onMassCancel({removed, reason, type});
+        publishBook();
+        return (int)removed.size();
     }
 
     void modifyOrder(int orderId, string field, double value) {
-        Order* oldOrder = findOrderInFiles(orderId);
-        if (!oldOrder) {
-            writeToConsole("Order ID " + to_string(orderId) + " not found.");
+        Order* liveOrder = findLiveOrder(orderId);
+        if (!liveOrder) {
+            sink.onMessage("Order ID " + to_string(orderId) + " not found.");
             return;
         }
 
-        Order* newOrder = new Order(*oldOrder);
+        Order newOrder(*liveOrder);
+        newOrder.timestamp = currentEpochNanos();
         
         if (field == "PRICE") {
-            newOrder->price = value;
-            string entry = "ID#" + to_string(orderId) + " | New Price: " + to_string(value);
-            appendToFile("all_info.txt", "ORDER MODIFIED: " + entry);
-            appendToCSV("ORDER MODIFIED", entry);
+            newOrder.price = value;
         } else if (field == "QTY") {
-            newOrder->quantity = (int)value;
-            string entry = "ID#" + to_string(orderId) + " | New QTY: " + to_string(value);
-            appendToFile("all_info.txt", "ORDER MODIFIED: " + entry);
-            appendToCSV("ORDER MODIFIED", entry);    
+            newOrder.quantity = (int)value;
         } else {
-            cout << "Invalid field. Use PRICE or QTY.\n";
-            delete newOrder;
+            sink.onMessage("Invalid field. Use PRICE or QTY.");
             return;
         }
 
-        bool found = false;
-        if (oldOrder->side == "BUY") {
-            auto& buyBook = orderBook.getBuyBook();
-            for (auto& priceLevelPair : buyBook) {
-                auto& queue = priceLevelPair.second;
-                for (auto it = queue.begin(); it != queue.end(); ++it) {
-                    if (it->id == orderId) {
-                        queue.erase(it);
-                        found = true;
-                        break;
-                    }
-                }
-                if (found) {
-                    if (queue.empty()) {
-                        buyBook.erase(priceLevelPair.first);
-                    }
-                    break;
-                }
-            }
-        } else {
-            auto& sellBook = orderBook.getSellBook();
-            for (auto& priceLevelPair : sellBook) {
-                auto& queue = priceLevelPair.second;
-                for (auto it = queue.begin(); it != queue.end(); ++it) {
-                    if (it->id == orderId) {
-                        queue.erase(it);
-                        found = true;
-                        break;
-                    }
-                }
-                if (found) {
-                    if (queue.empty()) {
-                        sellBook.erase(priceLevelPair.first);
-                    }
-                    break;
-                }
-            }
-        }
-
-        if (!found) {
-            writeToConsole("Order ID " + to_string(orderId) + " not found in book.");
-            delete newOrder;
+        string rejectReason = risk.checkAmend(newOrder, *liveOrder, orderBook);
+        if (!rejectReason.empty()) {
+            sink.onOrderRejected({newOrder, rejectReason, true});
             return;
         }
 
-        delete oldOrder;
+        Order removed(*liveOrder);
+        orderBook.removeOrder(orderId, liveOrder->side, liveOrder->price, removed);
+        risk.onRemove(removed, removed.quantity);
+        sink.onAmend({newOrder, field, value});
         
-        if (newOrder->side == "BUY") {
-            matchBuyOrder(*newOrder);
+        if (newOrder.side == "BUY") {
+            matchBuyOrder(newOrder);
         } else {
-            matchSellOrder(*newOrder);
+            matchSellOrder(newOrder);
         }
-        
-        writeOrderBookToFile();
-        writeToConsole("Order ID " + to_string(orderId) + " modified.");
+        processStops();
+        publishBook();
     }
     
-    void printOrderBook() {
-        orderBook.printOrderBook();
+    MarketImpact estimateImpact(const string& side, int quantity) const {
+        return orderBook.estimateImpact(side, quantity);
     }
 
-    void printTradeLog() {
-        cout << "\n=== TRADE LOG ===\n";
-        for (const auto& trade : tradeLog) {
-            cout << "BUY#" << trade.buyId << " <--> SELL#" << trade.sellId
-                      << " | Price: " << trade.price << " | Qty: " << trade.quantity
-                      << " | Time: " << trade.timestamp << "\n";
-        }
-    }
-
-    void printCanceledOrders() {
-        cout << "\n=== Canceled Orders ===\n";
-        for (const auto& entry : canceledOrders) {
-            const auto& order = entry.order;
-            cout << "ID#" << order.id 
-                    << " | " << order.side << " " << order.type
-                    << " | Qty: " << order.quantity 
-                    << " | Price: " << order.price 
-                    << " | Time: " << order.timestamp
-                    << " | Type: " << entry.type
-                    << " | Reason: " << entry.reason << "\n";
-        }
+    void printOrderBook() {
+        orderBook.printOrderBook();
     }
 
     void writeOrderBookToFile() {
-        ofstream buyFile("buy book.txt"), sellFile("sell book.txt");
-
-        buyFile << "=== BUY BOOK ===\n";
-        buyFile << "BUY ORDER BOOK (Last updated: " << currentTimestamp() << ")\n";
-        for (const auto& pair : orderBook.getBuyBook()) {
-            double price = pair.first;
-            const auto& queue = pair.second;
-            for (const auto& order : queue) {
-                buyFile << "ID#" << order.id << " | Qty: " << order.quantity 
-                        << " | Price: " << order.price << "\n";
-            }
-        }
-
-        sellFile << "=== SELL BOOK ===\n";
-        sellFile << "SELL ORDER BOOK (Last updated: " << currentTimestamp() << ")\n";
-        for (const auto& pair : orderBook.getSellBook()) {
-            double price = pair.first;
-            const auto& queue = pair.second;
-            for (const auto& order : queue) {
-                sellFile << "ID#" << order.id << " | Qty: " << order.quantity 
-                        << " | Price: " << order.price << "\n";
-            }
-        }
+        writeOrderBookFiles(orderBook);
     }
 
     void writeBuyBookToCSV() {
         ofstream file("buy book.csv");
-        file << "ID,Side,Type,Price,Quantity,Timestamp\n";
+        file << "ID,Side,Type,Price,Quantity,Timestamp,Account,TIF,ExpireAt\n";
         for (const auto& pair : orderBook.getBuyBook()) {
             double price = pair.first;
             const auto& queue = pair.second;
             for (const auto& order : queue) {
                 file << order.id << ",BUY," << order.type << "," 
                      << order.price << "," << order.quantity << "," 
-                     << order.timestamp << "\n";
+                     << order.timestamp << "," << order.account << ","
+                     << order.tif << "," << order.expireAt << "\n";
             }
         }
     }
 
     void writeSellBookToCSV() {
         ofstream file("sell book.csv");
-        file << "ID,Side,Type,Price,Quantity,Timestamp\n";
+        file << "ID,Side,Type,Price,Quantity,Timestamp,Account,TIF,ExpireAt\n";
         for (const auto& pair : orderBook.getSellBook()) {
             double price = pair.first;
             const auto& queue = pair.second;
             for (const auto& order : queue) {
                 file << order.id << ",SELL," << order.type << "," 
                      << order.price << "," << order.quantity << "," 
-                     << order.timestamp << "\n";
+                     << order.timestamp << "," << order.account << ","
+                     << order.tif << "," << order.expireAt << "\n";
+            }
+        }
+    }
+
+    void writeStopBookToCSV() {
+        ofstream file("stop book.csv");
+        file << "ID,Side,Type,Price,Quantity,Timestamp,Account,TIF,ExpireAt,StopPrice\n";
+        vector<const Order*> stops;
+        for (const auto& pair : stopBook.getBuyStops()) stops.push_back(&pair.second);
+        for (const auto& pair : stopBook.getSellStops()) stops.push_back(&pair.second);
+        for (const Order* order : stops) {
+            file << order->id << "," << order->side << "," << order->type << ","
+                 << order->price << "," << order->quantity << ","
+                 << order->timestamp << "," << order->account << ","
+                 << order->tif << "," << order->expireAt << "," << order->stopPrice << "\n";
+        }
+    }
+
+    void loadStopBookFromCSV() {
+        ifstream file("stop book.csv");
+        string line;
+        getline(file, line);
+        while (getline(file, line)) {
+            stringstream ss(line);
+            string idStr, side, type, priceStr, qtyStr, timestamp, account, tif, expireStr, stopStr;
+            getline(ss, idStr, ',');
+            getline(ss, side, ',');
+            getline(ss, type, ',');
+            getline(ss, priceStr, ',');
+            getline(ss, qtyStr, ',');
+            getline(ss, timestamp, ',');
+            getline(ss, account, ',');
+            getline(ss, tif, ',');
+            getline(ss, expireStr, ',');
+            getline(ss, stopStr);
+            if (idStr.empty() || stopStr.empty() || count(line.begin(), line.end(), ',') != 9) continue;
+
+            Order order(0, side, type, 0, 0, 0, account);
+            try {
+                order.id = stoi(idStr);
+                order.timestamp = parseTimestamp(timestamp);
+                order.price = stod(priceStr);
+                order.quantity = stoi(qtyStr);
+                order.expireAt = stoll(expireStr);
+                order.stopPrice = stod(stopStr);
+            } catch (const exception&) {
+                continue;
             }
+            order.tif = tif;
+            stopBook.addStop(order);
+            risk.onRest(order);
         }
     }
 
@@ -428,20 +450,41 @@ public:
         getline(file, line); 
         while (getline(file, line)) {
             stringstream ss(line);
-            string idStr, side, type, priceStr, qtyStr, timestamp;
+            string idStr, side, type, priceStr, qtyStr, timestamp, account, tif, expireStr;
             getline(ss, idStr, ',');
             getline(ss, side, ',');
             getline(ss, type, ',');
             getline(ss, priceStr, ',');
             getline(ss, qtyStr, ',');
-            getline(ss, timestamp);
-
-            int id = stoi(idStr);
-            double price = stod(priceStr);
-            int quantity = stoi(qtyStr);
+            getline(ss, timestamp, ',');
+            getline(ss, account, ',');
+            getline(ss, tif, ',');
+            getline(ss, expireStr);
+            if (account.empty()) account = "DEFAULT";
+            // Skip rows that cannot be parsed rather than failing every later command.
+            if (count(line.begin(), line.end(), ',') > 8) continue;
+
+            int id, quantity;
+            double price;
+            long long placedAt, expireAt = 0;
+            try {
+                id = stoi(idStr);
+                placedAt = parseTimestamp(timestamp);
+                price = stod(priceStr);
+                quantity = stoi(qtyStr);
+                if (!expireStr.empty()) expireAt = stoll(expireStr);
+            } catch (const exception&) {
+                continue;
+            }
 
-            Order order(id, side, type, price, quantity, timestamp);
+            Order order(id, side, type, price, quantity, placedAt, account);
+            if (!tif.empty()) order.tif = tif;
+            order.expireAt = expireAt;
             orderBook.addOrder(order);
+            risk.onRest(order);
+            if (order.expireAt > 0) {
+                expiryWheel.schedule(order.expireAt, order.id, order.side, order.price);
+            }
         }
     }
 
@@ -451,23 +494,56 @@ public:
         getline(file, line);  
         while (getline(file, line)) {
             stringstream ss(line);
-            string idStr, side, type, priceStr, qtyStr, timestamp;
+            string idStr, side, type, priceStr, qtyStr, timestamp, account, tif, expireStr;
             getline(ss, idStr, ',');
             getline(ss, side, ',');
             getline(ss, type, ',');
             getline(ss, priceStr, ',');
             getline(ss, qtyStr, ',');
-            getline(ss, timestamp);
-
-            int id = stoi(idStr);
-            double price = stod(priceStr);
-            int quantity = stoi(qtyStr);
+            getline(ss, timestamp, ',');
+            getline(ss, account, ',');
+            getline(ss, tif, ',');
+            getline(ss, expireStr);
+            if (account.empty()) account = "DEFAULT";
+            // Skip rows that cannot be parsed rather than failing every later command.
+            if (count(line.begin(), line.end(), ',') > 8) continue;
+
+            int id, quantity;
+            double price;
+            long long placedAt, expireAt = 0;
+            try {
+                id = stoi(idStr);
+                placedAt = parseTimestamp(timestamp);
+                price = stod(priceStr);
+                quantity = stoi(qtyStr);
+                if (!expireStr.empty()) expireAt = stoll(expireStr);
+            } catch (const exception&) {
+                continue;
+            }
 
-            Order order(id, side, type, price, quantity, timestamp);
+            Order order(id, side, type, price, quantity, placedAt, account);
+            if (!tif.empty()) order.tif = tif;
+            order.expireAt = expireAt;
             orderBook.addOrder(order);
+            risk.onRest(order);
+            if (order.expireAt > 0) {
+                expiryWheel.schedule(order.expireAt, order.id, order.side, order.price);
+            }
         }
     }
 
+    void saveRiskState() {
+        risk.saveState();
+    }
+
+    void loadRiskState() {
+        risk.loadState();
+    }
+
+    void restoreLastAssignedId() {
+        orderIdCounter = loadLastAssignedId();
+    }
+
     void saveLastAssignedId() {
         ofstream file("last_id.txt");
         file << orderIdCounter - 1; 
@@ -492,4 +568,6 @@ public:
     }   
 };
 
+using MatchingEngine = BasicMatchingEngine<FileEventSink>;
+
 #endif
\ No newline at end of file
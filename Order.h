@@ -10,15 +10,21 @@ struct Order{
     string type;  
     double price; 
     int quantity;
-    string timestamp; 
+    long long timestamp;     // epoch nanoseconds when placed or last modified
+    string account;
+    string tif = "GTC";      // GTC, IOC, FOK, DAY or GTD
+    long long expireAt = 0;  // epoch seconds, DAY/GTD only
+    double stopPrice = 0;    // trigger price, STOP/STOP_LIMIT only
 
-    Order(int id, string side, string type, double price, int quantity, string timestamp)
+    Order(int id, string side, string type, double price, int quantity, long long timestamp,
+          string account = "DEFAULT")
     : id(id),
       side(side),
       type(type),
       price(price),
       quantity(quantity),
-      timestamp(timestamp) {}
+      timestamp(timestamp),
+      account(account) {}
 };
 
-#endif
\ No newline at end of file
+#endif
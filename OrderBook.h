@@ -3,16 +3,182 @@
 
 #include <map>
 #include <deque>
+#include <vector>
+#include <algorithm>
 #include <iostream>
 #include "Order.h"
 using namespace std;
 
+// Result of a hypothetical market order walked against the live book.
+struct MarketImpact {
+    int requestedQty = 0;
+    int fillableQty = 0;       // less than requested when the side runs dry
+    double averagePrice = 0;
+    double worstPrice = 0;
+    int levelsConsumed = 0;
+};
+
 class OrderBook {
     
 private:
     map<double, deque<Order>, greater<double>> buyBook;
     map<double, deque<Order>> sellBook;
 
+    // Cached total quantity per price level, kept in step with the queues.
+    map<double, int, greater<double>> buyDepth;
+    map<double, int> sellDepth;
+
+    // Prefix sums over the level totals in priority order, rebuilt lazily
+    // after the depth of that side changes.
+    struct DepthPrefix {
+        vector<double> prices;
+        vector<long long> cumQty;
+        vector<double> cumNotional;
+        bool dirty = true;
+    };
+    mutable DepthPrefix buyPrefix;
+    mutable DepthPrefix sellPrefix;
+
+    template <typename DepthMap>
+    static void rebuildPrefix(const DepthMap& depth, DepthPrefix& prefix) {
+        prefix.prices.clear();
+        prefix.cumQty.clear();
+        prefix.cumNotional.clear();
+        long long qty = 0;
+        double notional = 0;
+        for (const auto& level : depth) {
+            qty += level.second;
+            notional += level.first * level.second;
+            prefix.prices.push_back(level.first);
+            prefix.cumQty.push_back(qty);
+            prefix.cumNotional.push_back(notional);
+        }
+        prefix.dirty = false;
+    }
+
+    // Iterators bounding the levels priced within [minPrice, maxPrice] of an
+    // ascending or descending price map. A bound of 0 means unbounded.
+    template <typename PriceMap>
+    static pair<typename PriceMap::iterator, typename PriceMap::iterator>
+    priceRange(PriceMap& levels, double minPrice, double maxPrice, bool descending) {
+        if (minPrice > 0 && maxPrice > 0 && minPrice > maxPrice) {
+            return {levels.end(), levels.end()};
+        }
+        double front = descending ? maxPrice : minPrice;
+        double back = descending ? minPrice : maxPrice;
+        auto first = front > 0 ? levels.lower_bound(front) : levels.begin();
+        auto last = back > 0 ? levels.upper_bound(back) : levels.end();
+        return {first, last};
+    }
+
+    // Removes whole levels in one erase when no account filter is given,
+    // otherwise filters each level in the range.
+    template <typename Book, typename DepthMap>
+    static void removeLevels(Book& book, DepthMap& depth, double minPrice, double maxPrice, bool descending,
+                             const string& account, vector<Order>& removed) {
+        auto range = priceRange(book, minPrice, maxPrice, descending);
+        if (account.empty()) {
+            for (auto it = range.first; it != range.second; ++it) {
+                removed.insert(removed.end(), it->second.begin(), it->second.end());
+            }
+            book.erase(range.first, range.second);
+            auto depthRange = priceRange(depth, minPrice, maxPrice, descending);
+            depth.erase(depthRange.first, depthRange.second);
+            return;
+        }
+
+        for (auto it = range.first; it != range.second;) {
+            deque<Order> kept;
+            for (const auto& order : it->second) {
+                if (order.account == account) {
+                    removed.push_back(order);
+                    reduceLevel(depth, it->first, order.quantity);
+                } else {
+                    kept.push_back(order);
+                }
+            }
+            if (kept.empty()) {
+                it = book.erase(it);
+            } else {
+                it->second.swap(kept);
+                ++it;
+            }
+        }
+    }
+
+    static MarketImpact walkPrefix(const DepthPrefix& prefix, int quantity) {
+        MarketImpact impact;
+        impact.requestedQty = quantity;
+        if (quantity <= 0 || prefix.cumQty.empty()) return impact;
+
+        size_t last = lower_bound(prefix.cumQty.begin(), prefix.cumQty.end(), (long long)quantity)
+                      - prefix.cumQty.begin();
+        if (last == prefix.cumQty.size()) {
+            last--;
+            impact.fillableQty = (int)prefix.cumQty[last];
+            impact.averagePrice = prefix.cumNotional[last] / prefix.cumQty[last];
+        } else {
+            long long before = last > 0 ? prefix.cumQty[last - 1] : 0;
+            double notionalBefore = last > 0 ? prefix.cumNotional[last - 1] : 0;
+            impact.fillableQty = quantity;
+            impact.averagePrice = (notionalBefore + (quantity - before) * prefix.prices[last]) / quantity;
+        }
+        impact.worstPrice = prefix.prices[last];
+        impact.levelsConsumed = (int)last + 1;
+        return impact;
+    }
+
+    template <typename DepthMap>
+    static void reduceLevel(DepthMap& depth, double price, int quantity) {
+        auto it = depth.find(price);
+        if (it == depth.end()) return;
+        it->second -= quantity;
+        if (it->second <= 0) {
+            depth.erase(it);
+        }
+    }
+
+    template <typename DepthMap>
+    static int availableUpTo(const DepthMap& depth, double limitPrice, bool isBuy, bool isMarket, int needed) {
+        int total = 0;
+        for (const auto& level : depth) {
+            if (!isMarket && (isBuy ? level.first > limitPrice : level.first < limitPrice)) break;
+            total += level.second;
+            if (total >= needed) break;
+        }
+        return total;
+    }
+
+    template <typename DepthMap>
+    static double worstPriceUpTo(const DepthMap& depth, int needed) {
+        double worst = 0;
+        int total = 0;
+        for (const auto& level : depth) {
+            worst = level.first;
+            total += level.second;
+            if (total >= needed) break;
+        }
+        return worst;
+    }
+
+    template <typename Book>
+    static bool removeFromBook(Book& book, int orderId, double price, Order& removed) {
+        auto level = book.find(price);
+        if (level == book.end()) return false;
+        auto& queue = level->second;
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (it->id == orderId) {
+                removed = *it;
+                queue.erase(it);
+                if (queue.empty()) {
+                    book.erase(level);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
 public:
     map<double, deque<Order>, greater<double>>& getBuyBook() {
         return buyBook;
@@ -22,12 +188,124 @@ public:
         return sellBook;
     }
 
+    const map<double, deque<Order>, greater<double>>& getBuyBook() const {
+        return buyBook;
+    }
+
+    const map<double, deque<Order>>& getSellBook() const {
+        return sellBook;
+    }
+
+    double getBestBid() const {
+        return buyBook.empty() ? 0 : buyBook.begin()->first;
+    }
+
+    double getBestAsk() const {
+        return sellBook.empty() ? 0 : sellBook.begin()->first;
+    }
+
+    Order* findOrder(int orderId, const string& side) {
+        if (side == "BUY") {
+            for (auto& pair : buyBook) {
+                for (auto& order : pair.second) {
+                    if (order.id == orderId) return &order;
+                }
+            }
+        } else {
+            for (auto& pair : sellBook) {
+                for (auto& order : pair.second) {
+                    if (order.id == orderId) return &order;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    const map<double, int, greater<double>>& getBuyDepth() const {
+        return buyDepth;
+    }
+
+    const map<double, int>& getSellDepth() const {
+        return sellDepth;
+    }
+
     void addOrder(const Order& order) {
         if (order.side == "BUY") {
             buyBook[order.price].push_back(order);
+            buyDepth[order.price] += order.quantity;
+            buyPrefix.dirty = true;
         } else if (order.side == "SELL") {
             sellBook[order.price].push_back(order);
+            sellDepth[order.price] += order.quantity;
+            sellPrefix.dirty = true;
+        }
+    }
+
+    // Must be called whenever a resting order's quantity drops (fill, cancel).
+    void reduceDepth(const string& side, double price, int quantity) {
+        if (side == "BUY") {
+            reduceLevel(buyDepth, price, quantity);
+            buyPrefix.dirty = true;
+        } else {
+            reduceLevel(sellDepth, price, quantity);
+            sellPrefix.dirty = true;
+        }
+    }
+
+    // Quantity an incoming order could take from the opposite side, walking
+    // the cached level totals and stopping once `needed` is reached.
+    int availableQuantity(const Order& incoming, int needed) const {
+        bool isMarket = incoming.type == "MARKET";
+        if (incoming.side == "BUY") {
+            return availableUpTo(sellDepth, incoming.price, true, isMarket, needed);
+        }
+        return availableUpTo(buyDepth, incoming.price, false, isMarket, needed);
+    }
+
+    // Deepest price a market order of `quantity` on `side` would reach (0 on
+    // an empty side). Walks only the levels the order would consume, so it is
+    // cheap enough for the pre-trade collar on every order.
+    double worstFillPrice(const string& side, int quantity) const {
+        if (side == "BUY") {
+            return worstPriceUpTo(sellDepth, quantity);
+        }
+        return worstPriceUpTo(buyDepth, quantity);
+    }
+
+    // What a market order of `quantity` on `side` would cost right now. Read
+    // only: after the first call following a book change this is a binary
+    // search over the cached prefix sums.
+    MarketImpact estimateImpact(const string& side, int quantity) const {
+        if (side == "BUY") {
+            if (sellPrefix.dirty) rebuildPrefix(sellDepth, sellPrefix);
+            return walkPrefix(sellPrefix, quantity);
+        }
+        if (buyPrefix.dirty) rebuildPrefix(buyDepth, buyPrefix);
+        return walkPrefix(buyPrefix, quantity);
+    }
+
+    // Bulk removal for mass cancel: every order on `side` ("BUY" or "SELL")
+    // priced within [minPrice, maxPrice] (0 = unbounded), optionally only those
+    // of one account. Removed orders are appended to `removed`.
+    void removeOrders(const string& side, double minPrice, double maxPrice, const string& account,
+                      vector<Order>& removed) {
+        if (side == "BUY") {
+            removeLevels(buyBook, buyDepth, minPrice, maxPrice, true, account, removed);
+            buyPrefix.dirty = true;
+        } else {
+            removeLevels(sellBook, sellDepth, minPrice, maxPrice, false, account, removed);
+            sellPrefix.dirty = true;
+        }
+    }
+
+    // Removes a resting order by id from a known price level.
+    bool removeOrder(int orderId, const string& side, double price, Order& removed) {
+        bool found = (side == "BUY") ? removeFromBook(buyBook, orderId, price, removed)
+                                     : removeFromBook(sellBook, orderId, price, removed);
+        if (found) {
+            reduceDepth(removed.side, removed.price, removed.quantity);
         }
+        return found;
     }
 
     void printOrderBook() {
@@ -0,0 +1,178 @@
+#ifndef RISKMANAGER_H
+#define RISKMANAGER_H
+
+#include <string>
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <stdexcept>
+#include "Order.h"
+#include "OrderBook.h"
+using namespace std;
+
+struct RiskLimits {
+    int maxOrderQty = 10000;          // largest single order accepted
+    double priceCollarPct = 0.20;     // allowed distance from the reference price
+    long long maxOpenQty = 100000;    // resting + pending stop quantity per account, both sides
+    long long maxPosition = 100000;   // |position + same-side open| per account
+};
+
+struct AccountRisk {
+    long long position = 0;
+    long long openBuyQty = 0;
+    long long openSellQty = 0;
+};
+
+// Pre-trade risk stage. All per-account state is kept as running counters,
+// updated as orders rest, fill and cancel, so a check is a single hash lookup
+// plus a few comparisons instead of a walk over the book.
+class RiskManager {
+private:
+    RiskLimits limits;
+    unordered_map<string, AccountRisk> accounts;
+    double lastTradePrice = 0;
+
+public:
+    RiskLimits& getLimits() {
+        return limits;
+    }
+
+    double getLastTradePrice() const {
+        return lastTradePrice;
+    }
+
+    const AccountRisk& getAccount(const string& account) {
+        return accounts[account];
+    }
+
+    // Returns an empty string when the order passes, otherwise the reject reason.
+    // replacedQty is the open quantity the order replaces (used by modify).
+    string checkOrder(const Order& order, const OrderBook& book, int replacedQty = 0,
+                      bool applyCollar = true) {
+        if (order.quantity <= 0) {
+            return "invalid_quantity";
+        }
+        if (order.quantity > limits.maxOrderQty) {
+            return "max_order_qty";
+        }
+
+        if ((order.type == "LIMIT" || order.type == "STOP_LIMIT") && order.price <= 0) {
+            return "invalid_price";
+        }
+
+        // Limit prices must sit inside the collar; market orders are held to
+        // the same band using the worst price they would reach in the book.
+        if (applyCollar && (order.type == "LIMIT" || order.type == "MARKET")) {
+            double reference = lastTradePrice;
+            double bestBid = book.getBestBid();
+            double bestAsk = book.getBestAsk();
+            if (reference == 0 && bestBid > 0 && bestAsk > 0) {
+                reference = (bestBid + bestAsk) / 2;
+            }
+            double price = order.price;
+            if (order.type == "MARKET") {
+                price = (reference > 0) ? book.worstFillPrice(order.side, order.quantity) : 0;
+            }
+            if (reference > 0 && price > 0) {
+                double band = reference * limits.priceCollarPct;
+                if (price > reference + band || price < reference - band) {
+                    return "price_collar";
+                }
+            }
+        }
+
+        const AccountRisk& acct = accounts[order.account];
+        long long delta = (long long)order.quantity - replacedQty;
+
+        if (acct.openBuyQty + acct.openSellQty + delta > limits.maxOpenQty) {
+            return "open_exposure_limit";
+        }
+
+        long long worstPosition = (order.side == "BUY")
+            ? acct.position + acct.openBuyQty + delta
+            : acct.position - acct.openSellQty - delta;
+        if (llabs(worstPosition) > limits.maxPosition) {
+            return "position_limit";
+        }
+
+        return "";
+    }
+
+    // Checks an amend of a resting order. A quantity reduction only lowers
+    // risk and always passes, so an order left outside the collar can still be
+    // reduced; the collar applies only when the price changes.
+    string checkAmend(const Order& amended, const Order& live, const OrderBook& book) {
+        if (amended.quantity <= 0) {
+            return "invalid_quantity";
+        }
+        bool priceChanged = amended.price != live.price;
+        if (!priceChanged && amended.quantity <= live.quantity) {
+            return "";
+        }
+        return checkOrder(amended, book, live.quantity, priceChanged);
+    }
+
+    void onRest(const Order& order) {
+        AccountRisk& acct = accounts[order.account];
+        if (order.side == "BUY") {
+            acct.openBuyQty += order.quantity;
+        } else {
+            acct.openSellQty += order.quantity;
+        }
+    }
+
+    void onRemove(const Order& order, int quantity) {
+        AccountRisk& acct = accounts[order.account];
+        if (order.side == "BUY") {
+            acct.openBuyQty -= quantity;
+        } else {
+            acct.openSellQty -= quantity;
+        }
+    }
+
+    void onFill(const Order& buyOrder, const Order& sellOrder, const Order& resting, int quantity, double price) {
+        accounts[buyOrder.account].position += quantity;
+        accounts[sellOrder.account].position -= quantity;
+        onRemove(resting, quantity);
+        lastTradePrice = price;
+    }
+
+    void saveState() {
+        ofstream file("positions.csv");
+        file << "Account,Position\n";
+        for (const auto& pair : accounts) {
+            if (pair.second.position != 0) {
+                file << pair.first << "," << pair.second.position << "\n";
+            }
+        }
+
+        ofstream priceFile("last_price.txt");
+        priceFile << lastTradePrice;
+    }
+
+    void loadState() {
+        ifstream file("positions.csv");
+        string line;
+        getline(file, line);
+        while (getline(file, line)) {
+            stringstream ss(line);
+            string account, positionStr;
+            getline(ss, account, ',');
+            getline(ss, positionStr);
+            if (account.empty() || positionStr.empty() || positionStr.find(',') != string::npos) continue;
+            try {
+                accounts[account].position = stoll(positionStr);
+            } catch (const exception&) {
+                continue;
+            }
+        }
+
+        ifstream priceFile("last_price.txt");
+        if (priceFile.is_open()) {
+            priceFile >> lastTradePrice;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef STOPBOOK_H
+#define STOPBOOK_H
+
+#include <map>
+#include <vector>
+#include "Order.h"
+using namespace std;
+
+// Pending STOP / STOP_LIMIT orders keyed by trigger price. Buy stops fire when
+// a trade prints at or above their trigger, sell stops at or below it, so
+// each side is ordered with the next order to fire at begin() and a trade
+// that triggers nothing costs two comparisons.
+class StopBook {
+private:
+    multimap<double, Order> buyStops;
+    multimap<double, Order, greater<double>> sellStops;
+
+    template <typename Stops>
+    static bool removeFrom(Stops& stops, int orderId, Order& removed) {
+        for (auto it = stops.begin(); it != stops.end(); ++it) {
+            if (it->second.id == orderId) {
+                removed = it->second;
+                stops.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Stops>
+    static void removeMatching(Stops& stops, double minPrice, double maxPrice, bool descending,
+                               const string& account, vector<Order>& removed) {
+        if (minPrice > 0 && maxPrice > 0 && minPrice > maxPrice) return;
+        double front = descending ? maxPrice : minPrice;
+        double back = descending ? minPrice : maxPrice;
+        auto it = front > 0 ? stops.lower_bound(front) : stops.begin();
+        auto last = back > 0 ? stops.upper_bound(back) : stops.end();
+        while (it != last) {
+            if (account.empty() || it->second.account == account) {
+                removed.push_back(it->second);
+                it = stops.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+public:
+    const multimap<double, Order>& getBuyStops() const {
+        return buyStops;
+    }
+
+    const multimap<double, Order, greater<double>>& getSellStops() const {
+        return sellStops;
+    }
+
+    bool empty() const {
+        return buyStops.empty() && sellStops.empty();
+    }
+
+    void addStop(const Order& order) {
+        if (order.side == "BUY") {
+            buyStops.emplace(order.stopPrice, order);
+        } else {
+            sellStops.emplace(order.stopPrice, order);
+        }
+    }
+
+    // Removes and returns every stop triggered by trades ranging from low to
+    // high: buy stops up to `high`, sell stops down to `low`, in trigger order.
+    vector<Order> popTriggered(double high, double low) {
+        vector<Order> triggered;
+
+        auto buyEnd = buyStops.upper_bound(high);
+        for (auto it = buyStops.begin(); it != buyEnd; ++it) {
+            triggered.push_back(it->second);
+        }
+        buyStops.erase(buyStops.begin(), buyEnd);
+
+        auto sellEnd = sellStops.upper_bound(low);
+        for (auto it = sellStops.begin(); it != sellEnd; ++it) {
+            triggered.push_back(it->second);
+        }
+        sellStops.erase(sellStops.begin(), sellEnd);
+
+        return triggered;
+    }
+
+    // Removes the stops on `side` ("BUY", "SELL" or "ALL") whose trigger price
+    // is within [minPrice, maxPrice] (0 = unbounded), optionally for one account.
+    void removeStops(const string& side, double minPrice, double maxPrice, const string& account,
+                     vector<Order>& removed) {
+        if (side != "SELL") {
+            removeMatching(buyStops, minPrice, maxPrice, false, account, removed);
+        }
+        if (side != "BUY") {
+            removeMatching(sellStops, minPrice, maxPrice, true, account, removed);
+        }
+    }
+
+    bool removeStop(int orderId, Order& removed) {
+        return removeFrom(buyStops, orderId, removed) || removeFrom(sellStops, orderId, removed);
+    }
+};
+
+#endif
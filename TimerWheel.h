@@ -0,0 +1,120 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <string>
+#include <vector>
+using namespace std;
+
+struct TimerEntry {
+    long long expireAt;   // epoch seconds
+    int orderId;
+    string side;
+    double price;
+};
+
+// Hierarchical timer wheel with one-second ticks. Level 0 holds timers due in
+// the next 64 seconds, each higher level covers 64x the range of the one below
+// and is cascaded down when the lower level wraps. Scheduling is O(1) and
+// advancing returns only the timers that are due, so expiring orders costs
+// O(expired) instead of a scan of the whole book.
+class TimerWheel {
+private:
+    static const int LEVELS = 5;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const long long SLOT_MASK = SLOTS - 1;
+
+    vector<TimerEntry> wheel[LEVELS][SLOTS];
+    size_t levelCount[LEVELS] = {};
+    vector<TimerEntry> due;
+    long long currentTime;
+    size_t pending = 0;
+
+    void place(const TimerEntry& entry) {
+        long long delta = entry.expireAt - currentTime;
+        if (delta <= 0) {
+            due.push_back(entry);
+            return;
+        }
+        for (int level = 0; level < LEVELS; level++) {
+            int shift = SLOT_BITS * (level + 1);
+            if (level == LEVELS - 1 || delta < (1LL << shift)) {
+                long long when = (level == LEVELS - 1 && delta >= (1LL << shift))
+                    ? currentTime + (1LL << shift) - 1
+                    : entry.expireAt;
+                wheel[level][(when >> (SLOT_BITS * level)) & SLOT_MASK].push_back(entry);
+                levelCount[level]++;
+                return;
+            }
+        }
+    }
+
+    // Moves every timer in the given slot down to the level that now fits it.
+    int cascade(int level, int index) {
+        vector<TimerEntry> entries;
+        entries.swap(wheel[level][index]);
+        levelCount[level] -= entries.size();
+        for (const auto& entry : entries) {
+            place(entry);
+        }
+        return index;
+    }
+
+public:
+    explicit TimerWheel(long long now = 0) : currentTime(now) {}
+
+    size_t size() const {
+        return pending;
+    }
+
+    void schedule(long long expireAt, int orderId, const string& side, double price) {
+        place({expireAt, orderId, side, price});
+        pending++;
+    }
+
+    // Advances the wheel to `now` and returns the timers that have come due.
+    vector<TimerEntry> advance(long long now) {
+        vector<TimerEntry> expired;
+        expired.swap(due);
+
+        while (currentTime < now) {
+            if (pending == expired.size()) {
+                currentTime = now;
+                break;
+            }
+
+            // While the lowest levels are empty nothing fires or cascades
+            // until the next boundary of the lowest occupied level.
+            int lowest = 0;
+            while (lowest < LEVELS - 1 && levelCount[lowest] == 0) lowest++;
+            if (lowest > 0 && due.empty()) {
+                long long boundary = currentTime | ((1LL << (SLOT_BITS * lowest)) - 1);
+                if (boundary >= now) {
+                    currentTime = now;
+                    break;
+                }
+                currentTime = boundary;
+            }
+            currentTime++;
+
+            int index = currentTime & SLOT_MASK;
+            for (int level = 1; index == 0 && level < LEVELS; level++) {
+                index = cascade(level, (currentTime >> (SLOT_BITS * level)) & SLOT_MASK);
+            }
+
+            // Level 0 slots hold timers due exactly at this tick; cascading may
+            // also route already-due timers into `due`.
+            vector<TimerEntry>& slot = wheel[0][currentTime & SLOT_MASK];
+            expired.insert(expired.end(), slot.begin(), slot.end());
+            levelCount[0] -= slot.size();
+            slot.clear();
+            expired.insert(expired.end(), due.begin(), due.end());
+            due.clear();
+        }
+
+        pending -= expired.size();
+        return expired;
+    }
+};
+
+#endif
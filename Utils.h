@@ -8,13 +8,42 @@
 #include <iomanip>
 using namespace std;
 
-inline string getCurrentTimestamp() {
-    auto now = chrono::system_clock::now();
-    time_t rawTime = chrono::system_clock::to_time_t(now);
-    tm* timeInfo = localtime(&rawTime);
-    ostringstream oss;
-    oss << put_time(timeInfo, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+// Raw clock read for order timestamps; no time zone lookup or formatting on
+// the matching path.
+inline long long currentEpochNanos() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Reads an order timestamp from the book CSVs: epoch nanoseconds, or the
+// "YYYY-mm-dd HH:MM:SS" local time written by older versions (0 if neither).
+inline long long parseTimestamp(const string& text) {
+    if (!text.empty() && text.find_first_not_of("0123456789") == string::npos) {
+        return stoll(text);
+    }
+    tm timeInfo = {};
+    istringstream iss(text);
+    iss >> get_time(&timeInfo, "%Y-%m-%d %H:%M:%S");
+    if (iss.fail()) return 0;
+    timeInfo.tm_isdst = -1;
+    return (long long)mktime(&timeInfo) * 1000000000LL;
+}
+
+inline long long currentEpochSeconds() {
+    return chrono::duration_cast<chrono::seconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// First second of the next local day; DAY orders expire at this point.
+inline long long endOfDayEpoch() {
+    time_t rawTime = chrono::system_clock::to_time_t(chrono::system_clock::now());
+    tm timeInfo = *localtime(&rawTime);
+    timeInfo.tm_hour = 0;
+    timeInfo.tm_min = 0;
+    timeInfo.tm_sec = 0;
+    timeInfo.tm_mday += 1;
+    timeInfo.tm_isdst = -1;
+    return (long long)mktime(&timeInfo);
 }
 
 #endif
\ No newline at end of file
@@ -184,7 +184,7 @@ with tab3:
     st.subheader("📊 Market vs Limit Order Ratio")
     order_df = df[df["Type"].str.upper() == "ORDER PLACED"].copy()
 
-    order_df["OrderType"] = order_df["Details"].str.extract(r"\|\s*(?:BUY|SELL)\s+(MARKET|LIMIT)\s")[0]
+    order_df["OrderType"] = order_df["Details"].str.extract(r"\|\s*(?:BUY|SELL)\s+(MARKET|LIMIT|STOP_LIMIT|STOP)\s")[0]
 
     order_type_counts = order_df["OrderType"].value_counts()
     st.bar_chart(order_type_counts)
@@ -229,7 +229,7 @@ with tab4:
 
     def parse_order_placed(df):
         df = df[df["Type"].str.upper() == "ORDER PLACED"]
-        pattern = r"ID#(\d+)\s*\|\s*(BUY|SELL)\s+(LIMIT|MARKET)?\s*\|\s*Price:\s*([\d.]+)\s*\|\s*Qty:\s*(\d+)"
+        pattern = r"ID#(\d+)\s*\|\s*(BUY|SELL)\s+(LIMIT|MARKET|STOP_LIMIT|STOP)?\s*\|\s*Price:\s*([\d.]+)\s*\|\s*Qty:\s*(\d+)"
         data = []
         for _, row in df.iterrows():
             m = re.search(pattern, row["Details"])
@@ -276,7 +276,7 @@ with tab4:
 
     def parse_cancellations(df):
         df = df[df["Type"].str.upper() == "ORDER CANCELED"]
-        pattern = r"ID#(\d+)\s*\|\s*(BUY|SELL)\s+(LIMIT|MARKET)?\s*\|\s*Qty:\s*(\d+)\s*\|\s*Reason:\s*(\w+)\s*\|\s*Type:\s*(\w+)"
+        pattern = r"ID#(\d+)\s*\|\s*(BUY|SELL)\s+(LIMIT|MARKET|STOP_LIMIT|STOP)?\s*\|\s*Qty:\s*(\d+)\s*\|\s*Reason:\s*(\w+)\s*\|\s*Type:\s*(\w+)"
         data = []
         for _, row in df.iterrows():
             m = re.search(pattern, row["Details"])
@@ -421,34 +421,84 @@ with tab1:
 
     command_type = st.selectbox(
         "Command Type",
-        ["PLACE", "CANCEL", "MODIFY", "CLEAR"],
+        ["PLACE", "CANCEL", "MASSCANCEL", "MODIFY", "QUOTE", "CLEAR"],
         key="command_type"
     )
 
     command = None
 
     if command_type == "PLACE":
-        col1, col2, col3, col4 = st.columns(4)
+        col1, col2, col3, col4, col5 = st.columns(5)
         with col1:
             side = st.selectbox("Side", ["BUY", "SELL"], key="place_side")
         with col2:
-            order_type = st.selectbox("Type", ["LIMIT", "MARKET"], key="place_type")
+            order_type = st.selectbox("Type", ["LIMIT", "MARKET", "STOP", "STOP_LIMIT"], key="place_type")
         with col4:
-            price = 0 if order_type == "MARKET" else st.number_input(
+            price = 0 if order_type in ("MARKET", "STOP") else st.number_input(
                 "Price", 
                 min_value=10, 
                 step=1, 
                 key="place_price",
-                disabled=(order_type == "MARKET")
+                disabled=(order_type in ("MARKET", "STOP"))
             )
         with col3:
             quantity = st.number_input("Quantity", min_value=1, step=1, key="place_qty")
+        with col5:
+            account = st.text_input("Account", value="DEFAULT", max_chars=31, key="place_account",
+                                    help="Letters, digits, _ and - only").strip()
+        tif_options = ["GTC", "IOC", "FOK"] if order_type != "LIMIT" else ["GTC", "IOC", "FOK", "DAY", "GTD"]
+        tif_col, expire_col, trigger_col = st.columns(3)
+        with tif_col:
+            tif = st.selectbox("Time in Force", tif_options, key="place_tif")
+        with expire_col:
+            expire_secs = st.number_input(
+                "Expires in (seconds)",
+                min_value=1,
+                step=1,
+                key="place_expire",
+                disabled=(tif != "GTD")
+            )
+        with trigger_col:
+            trigger = st.number_input(
+                "Trigger Price",
+                min_value=10,
+                step=1,
+                key="place_trigger",
+                disabled=(order_type not in ("STOP", "STOP_LIMIT"))
+            )
         command = f"PLACE {side} {order_type} {price} {quantity}"
+        if account:
+            command += f" ACCOUNT={account}"
+        if tif != "GTC":
+            command += f" TIF={tif}"
+        if tif == "GTD":
+            command += f" EXPIRE=+{expire_secs}"
+        if order_type in ("STOP", "STOP_LIMIT"):
+            command += f" TRIGGER={trigger}"
 
     elif command_type == "CANCEL":
         order_id = st.number_input("Order ID", min_value=1, step=1, key="cancel_id")
         command = f"CANCEL {order_id}"
 
+    elif command_type == "MASSCANCEL":
+        col1, col2, col3, col4 = st.columns(4)
+        with col1:
+            side = st.selectbox("Side", ["ALL", "BUY", "SELL"], key="mass_side")
+        with col2:
+            min_price = st.number_input("Min Price (0 = any)", min_value=0, step=1, key="mass_min")
+        with col3:
+            max_price = st.number_input("Max Price (0 = any)", min_value=0, step=1, key="mass_max")
+        with col4:
+            account = st.text_input("Account (blank = any)", max_chars=31, key="mass_account",
+                                    help="Letters, digits, _ and - only").strip()
+        command = f"MASSCANCEL {side}"
+        if min_price:
+            command += f" MIN={min_price}"
+        if max_price:
+            command += f" MAX={max_price}"
+        if account:
+            command += f" ACCOUNT={account}"
+
     elif command_type == "MODIFY":
         col1, col2, col3 = st.columns(3)
         with col1:
@@ -462,6 +512,14 @@ with tab1:
                 value = st.number_input("New Price", min_value=10, step=1, key="modify_price")
         command = f"MODIFY {order_id} {field} {value}"
 
+    elif command_type == "QUOTE":
+        col1, col2 = st.columns(2)
+        with col1:
+            side = st.selectbox("Side", ["BUY", "SELL"], key="quote_side")
+        with col2:
+            quantity = st.number_input("Quantity", min_value=1, step=1, key="quote_qty")
+        command = f"QUOTE {side} {quantity}"
+
     else:  
         st.info("This will clear all orders and logs. Admin password required.")
         password = st.text_input("Admin Password", type="password", key="admin_password")
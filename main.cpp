@@ -26,14 +26,29 @@ void createCSVFile() {
     cout << "File created successfully.\n";
 }
 
+// Account ids are written unquoted into the CSV books and positions.csv, so
+// they are limited to characters that cannot break a row. 31 characters is
+// also what the binary journal keeps.
+bool isValidAccount(const string& account) {
+    if (account.empty() || account.size() > 31) return false;
+    for (char c : account) {
+        if (!isalnum((unsigned char)c) && c != '_' && c != '-') return false;
+    }
+    return true;
+}
 
 int main() {
     clearConsoleLog();  
     createCSVFile();
     MatchingEngine engine;
     
+    engine.restoreLastAssignedId();
     engine.loadBuyBookFromCSVtoBuyOrderBook();
     engine.loadSellBookFromCSVtoSellOrderBook();
+    engine.loadStopBookFromCSV();
+    engine.loadRiskState();
+    engine.expireOrders();
+    engine.releaseCrossedStops();
     engine.writeOrderBookToFile();
 
     ifstream cmdFile("command.txt");
@@ -63,11 +78,75 @@ int main() {
             writeToConsole("Invalid side. Use BUY or SELL.");
             return 1;
         }
-        if (type != "LIMIT" && type != "MARKET") {
-            writeToConsole("Invalid type. Use LIMIT or MARKET.");
+        if (type != "LIMIT" && type != "MARKET" && type != "STOP" && type != "STOP_LIMIT") {
+            writeToConsole("Invalid type. Use LIMIT, MARKET, STOP or STOP_LIMIT.");
+            return 1;
+        }
+
+        string account = "DEFAULT";
+        string tif = "GTC";
+        string expire;
+        double trigger = 0;
+        string option;
+        while (ss >> option) {
+            if (option.rfind("ACCOUNT=", 0) == 0 && option.size() > 8) {
+                account = option.substr(8);
+                if (!isValidAccount(account)) {
+                    writeToConsole("Invalid account: " + account + ". Use up to 31 letters, digits, _ or -.");
+                    return 1;
+                }
+            } else if (option.rfind("TIF=", 0) == 0) {
+                tif = option.substr(4);
+            } else if (option.rfind("EXPIRE=", 0) == 0) {
+                expire = option.substr(7);
+            } else if (option.rfind("TRIGGER=", 0) == 0) {
+                try {
+                    trigger = stod(option.substr(8));
+                } catch (const exception&) {
+                    trigger = 0;
+                }
+            } else {
+                writeToConsole("Invalid option: " + option +
+                               ". Use ACCOUNT=<id>, TIF=<tif>, EXPIRE=<time> or TRIGGER=<price>.");
+                return 1;
+            }
+        }
+
+        bool isStop = (type == "STOP" || type == "STOP_LIMIT");
+        if (isStop != (trigger > 0)) {
+            writeToConsole("STOP and STOP_LIMIT orders need a positive TRIGGER=<price>, other orders take none.");
+            return 1;
+        }
+
+        if (tif != "GTC" && tif != "IOC" && tif != "FOK" && tif != "DAY" && tif != "GTD") {
+            writeToConsole("Invalid TIF. Use GTC, IOC, FOK, DAY or GTD.");
+            return 1;
+        }
+        if (type != "LIMIT" && (tif == "DAY" || tif == "GTD")) {
+            writeToConsole("DAY and GTD apply to LIMIT orders only.");
+            return 1;
+        }
+        if ((tif == "GTD") != !expire.empty()) {
+            writeToConsole("GTD orders need EXPIRE=<epoch seconds> or EXPIRE=+<seconds>, other orders take none.");
             return 1;
         }
-        engine.placeOrder(side, type, price, qty);
+
+        long long expireAt = 0;
+        long long now = currentEpochSeconds();
+        if (tif == "DAY") {
+            expireAt = endOfDayEpoch();
+        } else if (tif == "GTD") {
+            try {
+                expireAt = (expire[0] == '+') ? now + stoll(expire.substr(1)) : stoll(expire);
+            } catch (const exception&) {
+                expireAt = 0;
+            }
+            if (expireAt <= now) {
+                writeToConsole("Invalid EXPIRE. It must be in the future.");
+                return 1;
+            }
+        }
+        engine.placeOrder(side, type, price, qty, account, tif, expireAt, trigger);
     }
     else if (command == "CANCEL") {
         int id;
@@ -81,6 +160,63 @@ int main() {
         ss >> id >> field >> val;
         engine.modifyOrder(id, field, val);
     }
+    else if (command == "MASSCANCEL") {
+        string side;
+        ss >> side;
+        if (side != "ALL" && side != "BUY" && side != "SELL") {
+            writeToConsole("Invalid side. Use ALL, BUY or SELL.");
+            return 1;
+        }
+
+        double minPrice = 0, maxPrice = 0;
+        string account;
+        string option;
+        while (ss >> option) {
+            try {
+                if (option.rfind("MIN=", 0) == 0) {
+                    minPrice = stod(option.substr(4));
+                } else if (option.rfind("MAX=", 0) == 0) {
+                    maxPrice = stod(option.substr(4));
+                } else if (option.rfind("ACCOUNT=", 0) == 0 && option.size() > 8) {
+                    account = option.substr(8);
+                    if (!isValidAccount(account)) {
+                        writeToConsole("Invalid account: " + account + ". Use up to 31 letters, digits, _ or -.");
+                        return 1;
+                    }
+                } else {
+                    throw invalid_argument(option);
+                }
+            } catch (const exception&) {
+                writeToConsole("Invalid option: " + option + ". Use MIN=<price>, MAX=<price> or ACCOUNT=<id>.");
+                return 1;
+            }
+        }
+        if (minPrice < 0 || maxPrice < 0 || (minPrice > 0 && maxPrice > 0 && minPrice > maxPrice)) {
+            writeToConsole("Invalid price band. MIN must not exceed MAX.");
+            return 1;
+        }
+        engine.massCancel(side, minPrice, maxPrice, account);
+    }
+    else if (command == "QUOTE") {
+        string side;
+        int qty = 0;
+        ss >> side >> qty;
+        if ((side != "BUY" && side != "SELL") || qty <= 0) {
+            writeToConsole("Invalid quote. Use QUOTE [BUY/SELL] [QUANTITY].");
+            return 1;
+        }
+
+        MarketImpact impact = engine.estimateImpact(side, qty);
+        if (impact.fillableQty == 0) {
+            writeToConsole("QUOTE " + side + " " + to_string(qty) + " | No liquidity.");
+        } else {
+            writeToConsole("QUOTE " + side + " " + to_string(qty) +
+                           " | Fillable: " + to_string(impact.fillableQty) +
+                           " | Avg Price: " + to_string(impact.averagePrice) +
+                           " | Worst Price: " + to_string(impact.worstPrice) +
+                           " | Levels: " + to_string(impact.levelsConsumed));
+        }
+    }
     else if (command == "CLEAR") {
         clearLogs();
         writeToConsole("Logs cleared.");
@@ -94,6 +230,8 @@ int main() {
     engine.writeOrderBookToFile();
     engine.writeBuyBookToCSV();
     engine.writeSellBookToCSV();
+    engine.writeStopBookToCSV();
     engine.saveLastAssignedId();
+    engine.saveRiskState();
     return 0;
 }
\ No newline at end of file
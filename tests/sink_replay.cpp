@@ -0,0 +1,174 @@
+// Replays the flows in testcase.txt through the in-process event sinks and
+// checks the trades and cancels each testcase is expected to produce.
+//
+// Build and run from the repository root:
+//   g++ -std=c++11 tests/sink_replay.cpp -o sink_replay && ./sink_replay
+
+#include "../MatchingEngine.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+struct ExpectedTrade {
+    int buyId;
+    int sellId;
+    double price;
+    int quantity;
+};
+
+struct ExpectedCancel {
+    int id;
+    string reason;
+};
+
+struct Testcase {
+    vector<string> commands;
+    vector<ExpectedTrade> trades;
+    vector<ExpectedCancel> cancels;
+};
+
+static int failures = 0;
+
+static void check(bool ok, const string& what) {
+    if (!ok) {
+        cerr << "FAIL: " << what << "\n";
+        failures++;
+    }
+}
+
+// Splits testcase.txt into the command lists under each "Testcase N:" header.
+static vector<vector<string>> loadTestcases(const string& path) {
+    vector<vector<string>> testcases;
+    ifstream file(path);
+    string line;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.compare(0, 8, "Testcase") == 0) {
+            testcases.push_back({});
+        } else if (!testcases.empty() && !line.empty() && line != "EXIT") {
+            testcases.back().push_back(line);
+        }
+    }
+    return testcases;
+}
+
+template <typename EventSink>
+static void replay(BasicMatchingEngine<EventSink>& engine, const vector<string>& commands) {
+    for (const auto& line : commands) {
+        stringstream ss(line);
+        string command;
+        ss >> command;
+        if (command == "PLACE") {
+            string side, type;
+            double price;
+            int quantity;
+            ss >> side >> type >> price >> quantity;
+            engine.placeOrder(side, type, price, quantity);
+        } else if (command == "MODIFY") {
+            int id;
+            string field;
+            double value;
+            ss >> id >> field >> value;
+            engine.modifyOrder(id, field, value);
+        } else if (command == "CANCEL") {
+            int id;
+            ss >> id;
+            engine.cancelOrder(id);
+        }
+    }
+}
+
+static void checkCapture(const Testcase& testcase, const string& name) {
+    BasicMatchingEngine<CaptureEventSink> engine;
+    replay(engine, testcase.commands);
+    const CaptureEventSink& sink = engine.getEventSink();
+
+    check(sink.trades.size() == testcase.trades.size(), name + ": trade count");
+    for (size_t i = 0; i < sink.trades.size() && i < testcase.trades.size(); i++) {
+        const auto& got = sink.trades[i];
+        const auto& want = testcase.trades[i];
+        check(got.buyId == want.buyId && got.sellId == want.sellId &&
+              got.price == want.price && got.quantity == want.quantity,
+              name + ": trade " + to_string(i + 1));
+    }
+
+    check(sink.canceledOrders.size() == testcase.cancels.size(), name + ": cancel count");
+    for (size_t i = 0; i < sink.canceledOrders.size() && i < testcase.cancels.size(); i++) {
+        const auto& got = sink.canceledOrders[i];
+        const auto& want = testcase.cancels[i];
+        check(got.order.id == want.id && got.reason == want.reason,
+              name + ": cancel " + to_string(i + 1));
+    }
+    check(sink.rejected.empty(), name + ": no rejections");
+}
+
+// The other sinks only need to run the same flows; the journal must hold one
+// TRADE record per expected trade.
+static void checkOtherSinks(const Testcase& testcase, const string& name) {
+    {
+        BasicMatchingEngine<NullEventSink> engine;
+        replay(engine, testcase.commands);
+    }
+
+    remove("journal.bin");
+    {
+        BasicMatchingEngine<BinaryJournalSink> engine;
+        replay(engine, testcase.commands);
+    }
+    ifstream journal("journal.bin", ios::binary);
+    BinaryJournalSink::JournalRecord record;
+    size_t trades = 0;
+    while (journal.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.kind == BinaryJournalSink::TRADE) trades++;
+    }
+    journal.close();
+    remove("journal.bin");
+    check(trades == testcase.trades.size(), name + ": journal trade count");
+}
+
+int main() {
+    vector<vector<string>> flows = loadTestcases("testcase.txt");
+    if (flows.size() < 2) {
+        cerr << "Error: Could not read testcase.txt.\n";
+        return 1;
+    }
+
+    vector<Testcase> testcases(2);
+    testcases[0].commands = flows[0];
+    testcases[0].trades = {
+        {4, 1, 100, 5}, {6, 5, 102, 5}, {7, 5, 102, 5}, {4, 8, 100, 4}, {9, 10, 102, 3},
+        {3, 10, 102, 2}, {3, 11, 102, 5}, {3, 13, 102, 3}, {4, 13, 100, 2}
+    };
+    testcases[0].cancels = {
+        {2, "user_cancel"}, {7, "partial_market_unfilled"}, {12, "market_unfilled"}
+    };
+
+    testcases[1].commands = flows[1];
+    testcases[1].trades = {
+        {5, 6, 104, 3}, {7, 6, 103, 3}, {7, 1, 105, 5}, {3, 8, 100, 10}, {3, 9, 100, 5},
+        {10, 11, 97, 5}, {12, 11, 97, 5}, {12, 2, 102, 7}, {15, 14, 99, 5}, {17, 16, 99, 7},
+        {19, 2, 102, 3}, {19, 20, 110, 4}, {19, 21, 110, 3}, {23, 22, 108, 5}, {25, 24, 100, 10},
+        {25, 22, 108, 5}, {27, 26, 100, 10}
+    };
+    testcases[1].cancels = {
+        {4, "user_cancel"}, {13, "market_unfilled"}, {18, "market_unfilled"},
+        {1, "user_cancel"}, {27, "partial_market_unfilled"}
+    };
+
+    for (size_t i = 0; i < testcases.size(); i++) {
+        string name = "Testcase " + to_string(i + 1);
+        checkCapture(testcases[i], name);
+        checkOtherSinks(testcases[i], name);
+    }
+
+    if (failures > 0) {
+        cerr << failures << " check(s) failed.\n";
+        return 1;
+    }
+    cout << "All sink replays passed.\n";
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Checks stop triggering through the engine with CaptureEventSink: stops
+// swept through within one aggressor, multi-round cascades, and the leftover
+// of a cascade cut off at the round limit after a restart from the CSV files.
+//
+// Build and run from the repository root:
+//   g++ -std=c++11 tests/stop_trigger_check.cpp -o stop_trigger_check && ./stop_trigger_check
+
+#include "../MatchingEngine.h"
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool ok, const string& what) {
+    if (!ok) {
+        cerr << "FAIL: " << what << "\n";
+        failures++;
+    }
+}
+
+static bool triggered(const CaptureEventSink& sink, int id) {
+    for (const auto& order : sink.triggeredStops) {
+        if (order.id == id) return true;
+    }
+    return false;
+}
+
+// Last trade 97; a SELL MARKET then trades at 100 and 95. The buy stop at 98
+// must see the 100 and the sell stop at 96 must see the 95, even though
+// neither is the last price.
+static void checkSweep() {
+    BasicMatchingEngine<CaptureEventSink> engine;
+    const CaptureEventSink& sink = engine.getEventSink();
+    engine.placeOrder("BUY", "LIMIT", 97, 1);                     // 1
+    engine.placeOrder("SELL", "LIMIT", 97, 1);                    // 2
+    engine.placeOrder("BUY", "LIMIT", 100, 1);                    // 3
+    engine.placeOrder("BUY", "LIMIT", 95, 1);                     // 4
+    engine.placeOrder("SELL", "LIMIT", 110, 5);                   // 5
+    engine.placeOrder("BUY", "STOP", 0, 1, "DEFAULT", "GTC", 0, 98);   // 6
+    engine.placeOrder("BUY", "STOP", 0, 1, "DEFAULT", "GTC", 0, 111);  // 7
+    engine.placeOrder("SELL", "STOP", 0, 1, "DEFAULT", "GTC", 0, 96);  // 8
+    engine.placeOrder("SELL", "STOP", 0, 1, "DEFAULT", "GTC", 0, 94);  // 9
+    check(sink.triggeredStops.empty(), "no stop fires before the sweep");
+
+    engine.placeOrder("SELL", "MARKET", 0, 2);                    // 10
+    check(triggered(sink, 6), "buy stop fires on the traded high");
+    check(triggered(sink, 8), "sell stop fires on the traded low");
+    check(!triggered(sink, 7) && !triggered(sink, 9), "stops outside the range stay pending");
+    check(sink.trades.size() == 4 && sink.trades.back().price == 110, "triggered buy stop executes");
+}
+
+// Asks one apart from 100 up and a buy stop at every ask but the last: each
+// stop's fill prints the next trigger, so the chain fires one stop per round.
+static void placeChain(BasicMatchingEngine<CaptureEventSink>& engine, int length) {
+    for (int i = 0; i < length; i++) {
+        engine.placeOrder("SELL", "LIMIT", 100 + i, 1);
+    }
+    for (int i = 0; i < length - 1; i++) {
+        engine.placeOrder("BUY", "STOP", 0, 1, "DEFAULT", "GTC", 0, 100 + i);
+    }
+}
+
+static void checkCascade() {
+    BasicMatchingEngine<CaptureEventSink> engine;
+    const CaptureEventSink& sink = engine.getEventSink();
+    placeChain(engine, 10);
+    engine.placeOrder("BUY", "LIMIT", 100, 1);
+    check(sink.triggeredStops.size() == 9, "cascade fires every stop in the chain");
+    check(sink.trades.size() == 10 && sink.trades.back().price == 109, "cascade walks the asks");
+}
+
+// A 70-stop chain is cut off after 64 rounds. After saving and loading the
+// books in a fresh engine, the stops crossed by the last price fire.
+static void checkCascadeLimit() {
+    {
+        BasicMatchingEngine<CaptureEventSink> engine;
+        const CaptureEventSink& sink = engine.getEventSink();
+        placeChain(engine, 71);
+        engine.placeOrder("BUY", "LIMIT", 100, 1);
+        check(sink.triggeredStops.size() == 64, "cascade stops at the round limit");
+
+        engine.writeBuyBookToCSV();
+        engine.writeSellBookToCSV();
+        engine.writeStopBookToCSV();
+        engine.saveRiskState();
+        engine.saveLastAssignedId();
+    }
+
+    BasicMatchingEngine<CaptureEventSink> engine;
+    const CaptureEventSink& sink = engine.getEventSink();
+    engine.restoreLastAssignedId();
+    engine.loadBuyBookFromCSVtoBuyOrderBook();
+    engine.loadSellBookFromCSVtoSellOrderBook();
+    engine.loadStopBookFromCSV();
+    engine.loadRiskState();
+    engine.releaseCrossedStops();
+    check(sink.triggeredStops.size() == 6, "leftover stops fire after a restart");
+    check(sink.trades.size() == 6 && sink.trades.back().price == 170, "leftover stops execute");
+
+    const char* files[] = {
+        "buy book.csv", "sell book.csv", "stop book.csv", "positions.csv", "last_price.txt", "last_id.txt"
+    };
+    for (const char* file : files) {
+        remove(file);
+    }
+}
+
+int main() {
+    checkSweep();
+    checkCascade();
+    checkCascadeLimit();
+
+    if (failures > 0) {
+        cerr << failures << " check(s) failed.\n";
+        return 1;
+    }
+    cout << "All stop trigger checks passed.\n";
+    return 0;
+}
@@ -0,0 +1,176 @@
+// Checks the expiry timer wheel against a brute-force model, and DAY/GTD
+// expiry and FOK/IOC handling through the engine with CaptureEventSink.
+//
+// Build and run from the repository root (the engine expiry check waits two
+// seconds for a real timer to come due):
+//   g++ -std=c++11 tests/tif_expiry_check.cpp -o tif_expiry_check && ./tif_expiry_check
+
+#include "../MatchingEngine.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool ok, const string& what) {
+    if (!ok) {
+        cerr << "FAIL: " << what << "\n";
+        failures++;
+    }
+}
+
+// Every timer must come out of advance() exactly once, never before its
+// expiry and never after the advance that passed it.
+class WheelModel {
+private:
+    TimerWheel wheel;
+    long long now;
+    int nextId = 1;
+    map<int, long long> pending;   // id -> expireAt
+
+public:
+    explicit WheelModel(long long start) : wheel(start), now(start) {}
+
+    size_t size() const {
+        return pending.size();
+    }
+
+    void schedule(long long delta) {
+        long long expireAt = now + delta;
+        wheel.schedule(expireAt, nextId, "BUY", 100);
+        pending[nextId++] = expireAt;
+    }
+
+    void advance(long long step) {
+        now += step;
+        vector<TimerEntry> fired = wheel.advance(now);
+        for (const auto& entry : fired) {
+            auto it = pending.find(entry.orderId);
+            if (it == pending.end()) {
+                check(false, "timer " + to_string(entry.orderId) + " fired twice or was never scheduled");
+                continue;
+            }
+            check(it->second <= now, "timer " + to_string(entry.orderId) + " fired early");
+            pending.erase(it);
+        }
+        for (const auto& timer : pending) {
+            if (timer.second > now) continue;
+            check(false, "timer " + to_string(timer.first) + " missed at " + to_string(now));
+        }
+        check(wheel.size() == pending.size(), "pending count at " + to_string(now));
+    }
+};
+
+static void checkTimerWheel() {
+    const long long LEVEL_EDGES[] = {
+        -5, 0, 1, 63, 64, 65, 4095, 4096, 4097, (1LL << 18) - 1, 1LL << 18, (1LL << 18) + 1,
+        (1LL << 24) - 1, 1LL << 24, (1LL << 30) - 1, 1LL << 30, (1LL << 30) + 1, (1LL << 31) + 7
+    };
+
+    WheelModel model(1700000000);
+    for (long long delta : LEVEL_EDGES) {
+        model.schedule(delta);
+    }
+
+    // Timers at every level, added while the wheel moves in both single
+    // ticks and long jumps across level boundaries.
+    srand(27);
+    for (int round = 0; round < 3000; round++) {
+        int level = rand() % 6;
+        long long range = (level == 5) ? (1LL << 32) : (1LL << (6 * (level + 1)));
+        model.schedule(((long long)rand() * RAND_MAX + rand()) % range - (level == 0 ? 2 : 0));
+
+        int stepKind = rand() % 4;
+        long long step = (stepKind < 2) ? rand() % 3
+                       : (stepKind == 2) ? rand() % 5000
+                       : ((long long)rand() * RAND_MAX + rand()) % (1LL << 26);
+        model.advance(step);
+    }
+
+    for (int step = 0; step < 1024 && model.size() > 0; step++) {
+        model.advance(1LL << 24);
+    }
+    check(model.size() == 0, "all timers fire");
+    model.advance(1);
+}
+
+static bool hasCancel(const CaptureEventSink& sink, int id, const string& reason) {
+    for (const auto& canceled : sink.canceledOrders) {
+        if (canceled.order.id == id && canceled.reason == reason) return true;
+    }
+    return false;
+}
+
+static void checkFokIoc() {
+    BasicMatchingEngine<CaptureEventSink> engine;
+    const CaptureEventSink& sink = engine.getEventSink();
+    engine.placeOrder("SELL", "LIMIT", 100, 5);                     // 1
+    engine.placeOrder("SELL", "LIMIT", 101, 5);                     // 2
+
+    engine.placeOrder("BUY", "LIMIT", 101, 20, "DEFAULT", "FOK");    // 3
+    check(sink.trades.empty() && hasCancel(sink, 3, "fok_unfilled"), "FOK not fillable is canceled untouched");
+
+    engine.placeOrder("BUY", "LIMIT", 101, 8, "DEFAULT", "FOK");     // 4
+    check(sink.trades.size() == 2 && sink.canceledOrders.size() == 1, "fillable FOK fills completely");
+
+    engine.placeOrder("BUY", "LIMIT", 101, 5, "DEFAULT", "IOC");     // 5
+    check(sink.trades.size() == 3 && sink.trades.back().quantity == 2 &&
+          hasCancel(sink, 5, "partial_ioc_unfilled"), "IOC remainder is canceled");
+
+    engine.placeOrder("BUY", "LIMIT", 99, 4, "DEFAULT", "IOC");      // 6
+    check(hasCancel(sink, 6, "ioc_unfilled"), "unmatched IOC is canceled");
+
+    engine.placeOrder("SELL", "LIMIT", 102, 5);                     // 7
+    engine.placeOrder("BUY", "MARKET", 0, 6, "DEFAULT", "FOK");      // 8
+    check(hasCancel(sink, 8, "fok_unfilled") && sink.trades.size() == 3, "FOK market not fillable");
+}
+
+static void checkExpiry() {
+    BasicMatchingEngine<CaptureEventSink> engine;
+    const CaptureEventSink& sink = engine.getEventSink();
+    long long now = currentEpochSeconds();
+    long long endOfDay = endOfDayEpoch();
+
+    engine.placeOrder("BUY", "LIMIT", 100, 5, "DEFAULT", "GTD", now - 1);   // 1
+    engine.placeOrder("BUY", "LIMIT", 99, 5, "DEFAULT", "GTD", now + 1);    // 2
+    engine.placeOrder("BUY", "LIMIT", 98, 5, "DEFAULT", "GTD", now + 1);    // 3
+    engine.placeOrder("BUY", "LIMIT", 97, 5, "DEFAULT", "GTD", now + 3600); // 4
+    engine.placeOrder("BUY", "LIMIT", 96, 5, "DEFAULT", "DAY", endOfDay);  // 5
+    engine.placeOrder("BUY", "LIMIT", 95, 5);                              // 6
+
+    engine.expireOrders();
+    check(sink.canceledOrders.size() == 1 && hasCancel(sink, 1, "expired"), "past GTD expires immediately");
+
+    // Order 3 is canceled before its timer comes due; the stale timer must
+    // find nothing.
+    engine.cancelOrder(3);
+    this_thread::sleep_for(chrono::milliseconds(2100));
+    engine.expireOrders();
+
+    check(hasCancel(sink, 2, "expired"), "GTD expires after its time");
+    check(!hasCancel(sink, 3, "expired"), "canceled GTD is not expired again");
+    check(!hasCancel(sink, 4, "expired"), "future GTD stays");
+    if (endOfDay - now > 5) {
+        check(!hasCancel(sink, 5, "expired"), "DAY stays until end of day");
+    }
+    check(!hasCancel(sink, 6, "expired"), "GTC never expires");
+    check(sink.canceledOrders.size() == 3, "expiry cancel count");
+}
+
+int main() {
+    checkTimerWheel();
+    checkFokIoc();
+    checkExpiry();
+
+    if (failures > 0) {
+        cerr << failures << " check(s) failed.\n";
+        return 1;
+    }
+    cout << "All TIF and expiry checks passed.\n";
+    return 0;
+}